@@ -0,0 +1,8 @@
+function ffl_cancel(h)
+%FFL_CANCEL Cancel a background face landmarks job.
+%   FFL_CANCEL(h) Stop the job, discard its frames and release the handle.
+
+find_face_landmarks('ffl_cancel', h);
+
+end
+
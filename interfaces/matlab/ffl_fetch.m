@@ -0,0 +1,13 @@
+function frames = ffl_fetch(h, varargin)
+%FFL_FETCH Get the result of a background face landmarks job.
+%   frames = FFL_FETCH(h) Wait for the job to finish and return its frames
+%   in the same format as FIND_FACE_LANDMARKS. The job handle is released.
+%   If the job failed, its error is raised.
+%
+%   frames = FFL_FETCH(h, 'compact', true) Return the frames in the
+%   compact format of FIND_FACE_LANDMARKS.
+
+frames = find_face_landmarks('ffl_fetch', h, varargin{:});
+
+end
+
@@ -0,0 +1,13 @@
+function status = ffl_poll(h)
+%FFL_POLL Get the status of background face landmarks jobs.
+%   status = FFL_POLL(h):
+%   h - Job handle or an array of job handles returned by FFL_START
+%   status - An array of structs, one for each handle, with the fields:
+%       state - 'queued', 'running', 'done', 'failed' or 'canceled'
+%       frames - The number of processed frames
+%       total - The total number of frames, 0 if unknown
+
+status = find_face_landmarks('ffl_poll', h);
+
+end
+
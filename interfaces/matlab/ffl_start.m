@@ -0,0 +1,29 @@
+function h = ffl_start(modelFile, input, scale, track)
+%FFL_START Start finding face landmarks in a video in the background.
+%   h = FFL_START(modelFile, input, scale, track):
+%   modelFile - Path to the landmarks model file
+%   input - Path to an image, a video file, a directory containing a
+%       sequence of images, a posix regular expression or a device id
+%   scale [=1] - Each frame will be scaled by this factor
+%   track [=1] - Tracker type [0=NONE|1=BRISK|2=LBP]
+%   h - Job handle for FFL_POLL, FFL_FETCH and FFL_CANCEL
+%
+%   The jobs are queued and processed by native worker threads, so Matlab
+%   is not blocked. Landmarks models are loaded once and shared by all jobs.
+%
+%   Example
+%       h1 = ffl_start(modelFile, 'video1.mp4');
+%       h2 = ffl_start(modelFile, 'video2.mp4');
+%       status = ffl_poll([h1 h2]);
+%       frames1 = ffl_fetch(h1);
+
+if(~exist('scale','var'))
+    scale = 1;
+end
+if(~exist('track','var'))
+    track = 1;
+end
+h = find_face_landmarks('ffl_start', modelFile, input, scale, track);
+
+end
+
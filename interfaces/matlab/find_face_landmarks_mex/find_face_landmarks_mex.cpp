@@ -4,6 +4,12 @@
 #include <vector>
 #include <string>
 #include <exception>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <atomic>
 
 // Boost
 #include <boost/filesystem.hpp>
@@ -11,6 +17,8 @@
 // sfl
 #include <sfl/sequence_face_landmarks.h>
 #include <sfl/utilities.h>
+#include <sfl/video_source.h>
+#include <sfl/thread_pool.h>
 
 // OpenCV
 #include <opencv2/core.hpp>
@@ -31,11 +39,549 @@ using namespace boost::filesystem;
 // Global variables
 static std::shared_ptr<sfl::SequenceFaceLandmarks> g_sfl;
 static std::string g_landmarksModelPath;
+static std::vector<std::shared_ptr<sfl::SequenceFaceLandmarks>> g_sfl_workers;
+
+/** Options, specified as trailing name-value pairs.
+*/
+struct Options
+{
+	bool compact = false;	// Output flat numeric arrays instead of an array of structs
+	int first_frame = 0;	// First frame id to load from a landmarks file
+	int last_frame = -1;	// Last frame id to load from a landmarks file, -1 for all
+	std::vector<int> face_ids;	// Face ids to load from a landmarks file, empty for all
+};
+
+static std::string toLower(std::string s)
+{
+	std::transform(s.begin(), s.end(), s.begin(),
+		[](unsigned char c) { return (char)std::tolower(c); });
+	return s;
+}
+
+/** Parse the trailing name-value pairs and remove them from the positional arguments.
+Only known option names are consumed, so positional string arguments are not affected.
+*/
+static void parseOptions(int& nrhs, const mxArray *prhs[], Options& options)
+{
+	while (nrhs >= 2 && MxArray(prhs[nrhs - 2]).isChar())
+	{
+		std::string name = toLower(MxArray(prhs[nrhs - 2]).toString());
+		const MxArray value(prhs[nrhs - 1]);
+		if (name == "compact") options.compact = value.toBool();
+		else if (name == "range")	// Matlab's frame indices are 1-based
+		{
+			std::vector<double> range = value.toVector<double>();
+			if (range.size() != 2 || range[0] < 1 || range[1] < range[0])
+				throw runtime_error("range must be [first last] frame indices!");
+			options.first_frame = (int)range[0] - 1;
+			options.last_frame = std::isinf(range[1]) ? -1 : (int)range[1] - 1;
+		}
+		else if (name == "ids")
+		{
+			std::vector<double> ids = value.toVector<double>();
+			options.face_ids.assign(ids.begin(), ids.end());
+		}
+		else break;
+		nrhs -= 2;
+	}
+}
+
+/** A Matlab uint8 image referenced in place.
+*/
+struct MatlabImage
+{
+	const uint8_t* data;
+	int rows;
+	int cols;
+	int channels;
+};
+
+/** Convert a Matlab uint8 image directly to an OpenCV grayscale image.
+Matlab stores images column major with planar channels, so each plane is a transposed
+image. The planes are converted to grayscale in a single pass over contiguous memory
+with OpenCV's fixed point coefficients, and the result is transposed once.
+@param data The image data, rows-by-cols-by-channels in Matlab's layout.
+@param rows The number of image rows.
+@param cols The number of image columns.
+@param channels The number of channels, 1 for grayscale, 3 for RGB or 4 for RGBA.
+Only the first three planes of color images are used, alpha is ignored.
+@param gray The output grayscale image.
+*/
+static void matlabImageToGray(const uint8_t* data, int rows, int cols, int channels,
+	cv::Mat& gray)
+{
+	// The transposed grayscale buffer is reused between calls of the same thread
+	thread_local cv::Mat gray_t;
+	if (channels == 1)
+	{
+		cv::transpose(cv::Mat(cols, rows, CV_8U, (void*)data), gray);
+		return;
+	}
+	if (channels < 3) throw runtime_error("Matlab images must be grayscale, RGB or RGBA!");
+
+	// Y = 0.299 R + 0.587 G + 0.114 B in 14 bits fixed point
+	const int R2Y = 4899, G2Y = 9617, B2Y = 1868, SHIFT = 14;
+	const size_t n = (size_t)rows * cols;
+	const uint8_t* r = data;
+	const uint8_t* g = data + n;
+	const uint8_t* b = data + 2 * n;
+	gray_t.create(cols, rows, CV_8U);
+	uint8_t* dst = gray_t.data;
+	for (size_t i = 0; i < n; ++i)
+		dst[i] = (uint8_t)((r[i] * R2Y + g[i] * G2Y + b[i] * B2Y + (1 << (SHIFT - 1))) >> SHIFT);
+	cv::transpose(gray_t, gray);
+}
+
+/** Convert a Matlab uint8 image argument to an OpenCV grayscale image.
+*/
+static void matlabImageToGray(const MxArray& img, cv::Mat& gray)
+{
+	const mwSize* dims = img.dims();
+	int channels = img.ndims() > 2 ? (int)dims[2] : 1;
+	matlabImageToGray((const uint8_t*)mxGetData(img), (int)dims[0], (int)dims[1],
+		channels, gray);
+}
+
+/** Return true if the argument is a batch of images: a 4-D uint8 array of
+rows-by-cols-by-channels-by-n images or a cell array of uint8 images.
+*/
+static bool isImageBatch(const MxArray& arr)
+{
+	return (arr.isUint8() && arr.ndims() == 4) || arr.isCell();
+}
+
+/** Get references to all the images of a batch without copying them.
+*/
+static void getImageBatch(const MxArray& arr, std::vector<MatlabImage>& images)
+{
+	images.clear();
+	if (arr.isCell())
+	{
+		images.reserve(arr.numel());
+		for (mwIndex i = 0; i < arr.numel(); ++i)
+		{
+			const mxArray* cell = mxGetCell(arr, i);
+			if (cell == nullptr) throw runtime_error("Each cell must contain a uint8 image!");
+			const MxArray img(cell);
+			if (!img.isUint8() || img.ndims() > 3)
+				throw runtime_error("Each cell must contain a uint8 image!");
+			const mwSize* dims = img.dims();
+			images.push_back({ (const uint8_t*)mxGetData(img), (int)dims[0], (int)dims[1],
+				img.ndims() > 2 ? (int)dims[2] : 1 });
+		}
+	}
+	else
+	{
+		const mwSize* dims = arr.dims();
+		const size_t image_size = dims[0] * dims[1] * dims[2];
+		const uint8_t* data = (const uint8_t*)mxGetData(arr);
+		images.reserve(dims[3]);
+		for (mwSize i = 0; i < dims[3]; ++i)
+			images.push_back({ data + i * image_size, (int)dims[0], (int)dims[1], (int)dims[2] });
+	}
+}
+
+/** Process a batch of independent images on the thread pool.
+The images are split into contiguous chunks, each chunk is processed by its own copy
+of g_sfl and the resulting frames are appended to g_sfl's sequence in order.
+Only the images data is accessed by the workers, all the Matlab API calls are
+done by the calling thread.
+*/
+static void processImageBatch(const std::vector<MatlabImage>& images)
+{
+	if (images.empty()) return;
+	sfl::ThreadPool& pool = sfl::ThreadPool::global();
+	const size_t chunks = std::min(images.size(), pool.size() + 1);
+
+	// The copies are kept between calls, they share the landmarks model of g_sfl
+	while (g_sfl_workers.size() < chunks)
+	{
+		g_sfl_workers.push_back(g_sfl->clone());
+		g_sfl_workers.back()->setTracking(sfl::TRACKING_NONE);
+	}
+
+	pool.parallelFor(chunks, [&](size_t c)
+	{
+		sfl::SequenceFaceLandmarks& worker = *g_sfl_workers[c];
+		worker.clear();
+		worker.setFrameScale(g_sfl->getFrameScale());
+		cv::Mat gray;
+		const size_t first = images.size() * c / chunks;
+		const size_t last = images.size() * (c + 1) / chunks;
+		for (size_t i = first; i < last; ++i)
+		{
+			const MatlabImage& img = images[i];
+			matlabImageToGray(img.data, img.rows, img.cols, img.channels, gray);
+			worker.addFrame(gray, (int)i);
+		}
+	});
+
+	// Move the frames of all chunks to the main sequence
+	std::list<std::unique_ptr<sfl::Frame>>& sequence = g_sfl->getSequenceMutable();
+	for (size_t c = 0; c < chunks; ++c)
+	{
+		sequence.splice(sequence.end(), g_sfl_workers[c]->getSequenceMutable());
+		g_sfl_workers[c]->clear();
+	}
+}
+
+/** Create the frames as a 1-by-n array of structs, each frame holds a 1-by-m array
+of face structs.
+*/
+static mxArray* createFramesStruct(const std::list<std::unique_ptr<sfl::Frame>>& sfl_frames)
+{
+	mwSize dims[2] = { 1, 1 };
+	dims[1] = sfl_frames.size();
+	const char *frame_fields[] = { "faces", "width", "height" };
+	const char *face_fields[] = { "landmarks", "bbox" };
+	mxArray* framesStructArray = mxCreateStructArray(2, dims, 3, frame_fields);
+
+	// For each frame
+	size_t i = 0;
+	for (auto& sfl_frame : sfl_frames)
+	{
+		// Set the width and height to the fields of the current frame
+		mxSetField(framesStructArray, i, frame_fields[1], MxArray(sfl_frame->width));
+		mxSetField(framesStructArray, i, frame_fields[2], MxArray(sfl_frame->height));
+
+		const std::list<std::unique_ptr<sfl::Face>>& faces = sfl_frame->faces;
+		if (faces.empty())
+		{
+			++i;
+			continue;
+		}
+
+		// Create the faces as a 1-by-n array of structs.
+		dims[1] = faces.size();
+		mxArray* facesStructArray = mxCreateStructArray(2, dims, 2, face_fields);
+
+		// Set the faces to the field of the current frame
+		mxSetField(framesStructArray, i++, frame_fields[0], facesStructArray);
+
+		// For each face
+		size_t j = 0;
+		for (auto& face : faces)
+		{
+			// Convert the landmarks to Matlab's pixel format (column major, 1-based)
+			const size_t n = face->landmarks.size();
+			mxArray* landmarks = mxCreateNumericMatrix(n, 2, mxINT32_CLASS, mxREAL);
+			int32_t* landmarks_data = (int32_t*)mxGetData(landmarks);
+			for (size_t k = 0; k < n; ++k)
+			{
+				landmarks_data[k] = face->landmarks[k].x + 1;
+				landmarks_data[n + k] = face->landmarks[k].y + 1;
+			}
+
+			// Set the landmarks to the field of the current face
+			mxSetField(facesStructArray, j, face_fields[0], landmarks);
+
+			// Convert the bounding box to Matlab's pixel format
+			mxArray* bbox = mxCreateNumericMatrix(1, 4, mxINT32_CLASS, mxREAL);
+			int32_t* bbox_data = (int32_t*)mxGetData(bbox);
+			bbox_data[0] = face->bbox.x + 1;
+			bbox_data[1] = face->bbox.y + 1;
+			bbox_data[2] = face->bbox.width;
+			bbox_data[3] = face->bbox.height;
+
+			// Set the bounding to the field of the current face
+			mxSetField(facesStructArray, j++, face_fields[1], bbox);
+		}
+	}
+
+	return framesStructArray;
+}
+
+/** Create a single struct of flat numeric arrays holding all the faces of the sequence:
+landmarks - int32 p-by-2-by-n landmarks of all n faces (p is the number of points).
+bbox - int32 n-by-4 bounding boxes [x y width height].
+frame - int32 n-by-1 1-based position of each face's frame in the f-by-1 arrays.
+id - int32 n-by-1 face id of each face.
+width, height - int32 f-by-1 size of each of the f frames.
+frame_id - int32 f-by-1 1-based id of each of the f frames.
+*/
+static mxArray* createCompactStruct(const std::list<std::unique_ptr<sfl::Frame>>& sfl_frames)
+{
+	// Count the faces and the maximum number of landmarks per face
+	size_t total_faces = 0, points = 0;
+	for (auto& sfl_frame : sfl_frames)
+	{
+		total_faces += sfl_frame->faces.size();
+		for (auto& face : sfl_frame->faces)
+			points = std::max(points, face->landmarks.size());
+	}
+
+	// Allocate all the output arrays at once
+	const mwSize landmarks_dims[3] = { points, 2, total_faces };
+	mxArray* landmarks = mxCreateNumericArray(3, landmarks_dims, mxINT32_CLASS, mxREAL);
+	mxArray* bbox = mxCreateNumericMatrix(total_faces, 4, mxINT32_CLASS, mxREAL);
+	mxArray* frame_index = mxCreateNumericMatrix(total_faces, 1, mxINT32_CLASS, mxREAL);
+	mxArray* face_id = mxCreateNumericMatrix(total_faces, 1, mxINT32_CLASS, mxREAL);
+	mxArray* width = mxCreateNumericMatrix(sfl_frames.size(), 1, mxINT32_CLASS, mxREAL);
+	mxArray* height = mxCreateNumericMatrix(sfl_frames.size(), 1, mxINT32_CLASS, mxREAL);
+	mxArray* frame_id = mxCreateNumericMatrix(sfl_frames.size(), 1, mxINT32_CLASS, mxREAL);
+	int32_t* landmarks_data = (int32_t*)mxGetData(landmarks);
+	int32_t* bbox_data = (int32_t*)mxGetData(bbox);
+	int32_t* frame_index_data = (int32_t*)mxGetData(frame_index);
+	int32_t* face_id_data = (int32_t*)mxGetData(face_id);
+	int32_t* width_data = (int32_t*)mxGetData(width);
+	int32_t* height_data = (int32_t*)mxGetData(height);
+	int32_t* frame_id_data = (int32_t*)mxGetData(frame_id);
+
+	// Fill the arrays in Matlab's column major order and pixel format (1-based).
+	// The frame index of each face is the frame's position in the per frame arrays
+	size_t i = 0;
+	int32_t position = 0;
+	for (auto& sfl_frame : sfl_frames)
+	{
+		*width_data++ = sfl_frame->width;
+		*height_data++ = sfl_frame->height;
+		*frame_id_data++ = sfl_frame->id + 1;
+		++position;
+		for (auto& face : sfl_frame->faces)
+		{
+			int32_t* x = landmarks_data + i * points * 2;
+			int32_t* y = x + points;
+			for (const cv::Point& p : face->landmarks)
+			{
+				*x++ = p.x + 1;
+				*y++ = p.y + 1;
+			}
+
+			bbox_data[i] = face->bbox.x + 1;
+			bbox_data[total_faces + i] = face->bbox.y + 1;
+			bbox_data[2 * total_faces + i] = face->bbox.width;
+			bbox_data[3 * total_faces + i] = face->bbox.height;
+			frame_index_data[i] = position;
+			face_id_data[i] = face->id;
+			++i;
+		}
+	}
+
+	const char *fields[] = { "landmarks", "bbox", "frame", "id", "width", "height", "frame_id" };
+	mxArray* compact = mxCreateStructMatrix(1, 1, 7, fields);
+	mxSetField(compact, 0, fields[0], landmarks);
+	mxSetField(compact, 0, fields[1], bbox);
+	mxSetField(compact, 0, fields[2], frame_index);
+	mxSetField(compact, 0, fields[3], face_id);
+	mxSetField(compact, 0, fields[4], width);
+	mxSetField(compact, 0, fields[5], height);
+	mxSetField(compact, 0, fields[6], frame_id);
+	return compact;
+}
+
+/** Background processing job state.
+*/
+enum JobState
+{
+	JOB_QUEUED = 0,
+	JOB_RUNNING = 1,
+	JOB_DONE = 2,
+	JOB_FAILED = 3,
+	JOB_CANCELED = 4
+};
+
+static const char* getJobStateName(JobState state)
+{
+	static const char* names[] = { "queued", "running", "done", "failed", "canceled" };
+	return names[state];
+}
+
+/** A video processed in the background by the job thread pool.
+The sequence is only accessed by Matlab's thread after the job has finished.
+*/
+struct Job
+{
+	std::string model_path;
+	std::string input_path;
+	int device = -1;
+	float frame_scale = 1.0f;
+	int track = 1;
+	std::atomic<int> state{ JOB_QUEUED };
+	std::atomic<int> frames{ 0 };
+	std::atomic<int> total_frames{ 0 };
+	std::atomic<bool> cancel{ false };
+	std::exception_ptr error;
+	std::shared_ptr<sfl::SequenceFaceLandmarks> sfl;
+	std::future<void> finished;
+};
+
+// Background jobs
+static std::unique_ptr<sfl::ThreadPool> g_job_pool;
+static std::map<int, std::shared_ptr<Job>> g_jobs;
+static int g_next_job_id = 1;
+static std::map<std::string, std::shared_ptr<sfl::SequenceFaceLandmarks>> g_job_models;
+static std::mutex g_job_models_mutex;
+
+/** Get a copy of a resident landmarks model, the model is loaded only once.
+*/
+static std::shared_ptr<sfl::SequenceFaceLandmarks> getJobModel(const std::string& model_path)
+{
+	std::lock_guard<std::mutex> lock(g_job_models_mutex);
+	std::shared_ptr<sfl::SequenceFaceLandmarks>& model = g_job_models[model_path];
+	if (!model) model = sfl::SequenceFaceLandmarks::create(model_path);
+	return model->clone();
+}
+
+static void runJob(Job& job)
+{
+	if (job.cancel)
+	{
+		job.state = JOB_CANCELED;
+		return;
+	}
+	job.state = JOB_RUNNING;
+	try
+	{
+		job.sfl = getJobModel(job.model_path);
+		job.sfl->setFrameScale(job.frame_scale);
+		job.sfl->setTracking((sfl::FaceTrackingType)job.track);
+
+		// Create video source
+		sfl::VideoSource video_source;
+		bool opened = job.device >= 0 ? video_source.open(job.device) :
+			video_source.open(job.input_path);
+		if (!opened) throw runtime_error("Failed to open video source!");
+		job.total_frames = std::max(video_source.getFrameCount(), 0);
+
+		// Main loop
+		cv::Mat frame;
+		while (!job.cancel && video_source.read(frame))
+		{
+			job.sfl->addFrame(frame);
+			++job.frames;
+		}
+		job.state = job.cancel ? JOB_CANCELED : JOB_DONE;
+	}
+	catch (...)
+	{
+		job.error = std::current_exception();
+		job.state = JOB_FAILED;
+	}
+}
+
+/** Cancel all jobs and wait for the job threads, called when the MEX is cleared
+or Matlab exits. The library's global pool is stopped as well, its workers
+can't be joined safely once the MEX is being unloaded.
+*/
+static void stopJobs()
+{
+	for (auto& job : g_jobs) job.second->cancel = true;
+	g_job_pool.reset();
+	g_jobs.clear();
+	g_job_models.clear();
+	sfl::ThreadPool::global().shutdown();
+}
+
+static std::shared_ptr<Job> getJob(const MxArray& handle)
+{
+	auto it = g_jobs.find(handle.toInt());
+	if (it == g_jobs.end()) throw runtime_error("Invalid job handle!");
+	return it->second;
+}
+
+/** Remove a finished job. Each running job locks the MEX in memory.
+*/
+static void removeJob(int id)
+{
+	g_jobs.erase(id);
+	mexUnlock();
+}
+
+/** Handle the background job commands:
+h = ffl_start(modelFile, input, scale, track) - Queue a video for processing.
+status = ffl_poll(h) - Get the status of one or more jobs without blocking.
+frames = ffl_fetch(h) - Wait for a job to finish and get its frames.
+ffl_cancel(h) - Cancel a job and discard its frames.
+*/
+static void jobCommand(const std::string& cmd, int nlhs, mxArray *plhs[], int nrhs,
+	const mxArray *prhs[], const Options& options)
+{
+	if (cmd == "ffl_start")
+	{
+		if (nrhs < 3) throw runtime_error("ffl_start requires a model file and an input!");
+		std::shared_ptr<Job> job = std::make_shared<Job>();
+		job->model_path = MxArray(prhs[1]).toString();
+		if (MxArray(prhs[2]).isChar())
+		{
+			job->input_path = MxArray(prhs[2]).toString();
+			job->device = sfl::getDeviceID(job->input_path);
+		}
+		else job->device = MxArray(prhs[2]).toInt();
+		if (nrhs > 3) job->frame_scale = (float)MxArray(prhs[3]).toDouble();
+		if (nrhs > 4) job->track = MxArray(prhs[4]).toInt();
+
+		if (!g_job_pool) g_job_pool = std::make_unique<sfl::ThreadPool>();
+		int id = g_next_job_id++;
+		g_jobs[id] = job;
+		mexLock();
+		job->finished = g_job_pool->enqueue([job]() { runJob(*job); });
+		plhs[0] = MxArray(id);
+	}
+	else if (cmd == "ffl_poll")
+	{
+		if (nrhs < 2) throw runtime_error("ffl_poll requires a job handle!");
+		const MxArray handles(prhs[1]);
+		const char *fields[] = { "state", "frames", "total" };
+		mxArray* status = mxCreateStructMatrix(1, handles.numel(), 3, fields);
+		std::vector<double> ids = handles.toVector<double>();
+		for (size_t i = 0; i < ids.size(); ++i)
+		{
+			auto it = g_jobs.find((int)ids[i]);
+			if (it == g_jobs.end()) throw runtime_error("Invalid job handle!");
+			const Job& job = *it->second;
+			mxSetField(status, i, fields[0], MxArray(std::string(
+				getJobStateName((JobState)job.state.load()))));
+			mxSetField(status, i, fields[1], MxArray(job.frames.load()));
+			mxSetField(status, i, fields[2], MxArray(job.total_frames.load()));
+		}
+		plhs[0] = status;
+	}
+	else if (cmd == "ffl_fetch")
+	{
+		if (nrhs < 2) throw runtime_error("ffl_fetch requires a job handle!");
+		int id = MxArray(prhs[1]).toInt();
+		std::shared_ptr<Job> job = getJob(MxArray(prhs[1]));
+		job->finished.wait();
+		removeJob(id);
+		if (job->state == JOB_FAILED) std::rethrow_exception(job->error);
+		if (job->state == JOB_CANCELED) throw runtime_error("The job was canceled!");
+
+		const std::list<std::unique_ptr<sfl::Frame>>& sfl_frames = job->sfl->getSequence();
+		if (options.compact) plhs[0] = createCompactStruct(sfl_frames);
+		else plhs[0] = createFramesStruct(sfl_frames);
+	}
+	else if (cmd == "ffl_cancel")
+	{
+		if (nrhs < 2) throw runtime_error("ffl_cancel requires a job handle!");
+		int id = MxArray(prhs[1]).toInt();
+		std::shared_ptr<Job> job = getJob(MxArray(prhs[1]));
+		job->cancel = true;
+		job->finished.wait();
+		removeJob(id);
+	}
+	else throw runtime_error("Unknown command: " + cmd);
+}
 
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
+	mexAtExit(stopJobs);
 	try
 	{
+		// Parse trailing name-value options
+		Options options;
+		parseOptions(nrhs, prhs, options);
+
+		// Background job commands
+		if (nrhs > 0 && MxArray(prhs[0]).isChar())
+		{
+			std::string cmd = MxArray(prhs[0]).toString();
+			if (cmd.compare(0, 4, "ffl_") == 0)
+			{
+				jobCommand(cmd, nlhs, plhs, nrhs, prhs, options);
+				return;
+			}
+		}
+
 		// Parse arguments
 		std::string inputPath, landmarksModelPath, landmarksPath;
 		int device = -1;
@@ -44,6 +590,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 		float frame_scale = 1.0f;
 		bool preview = true;
 		cv::Mat matlab_img;
+		std::vector<MatlabImage> matlab_imgs;
 		if (nrhs == 0) throw runtime_error("No parameters specified!");
 		if (nrhs == 1)
 		{
@@ -69,13 +616,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 				}
 				inputPath.clear();
 			}
+			else if (isImageBatch(MxArray(prhs[0])))	// Matlab image batch
+			{
+				if (g_landmarksModelPath.empty()) throw runtime_error(
+					"A landmarks model file must be specified first!");
+				getImageBatch(MxArray(prhs[0]), matlab_imgs);
+			}
 			else if (MxArray(prhs[0]).isUint8() && MxArray(prhs[0]).ndims() > 1)	// Matlab image
 			{
 				if(g_landmarksModelPath.empty()) throw runtime_error(
 					"A landmarks model file must be specified first!");
-				matlab_img = MxArray(prhs[0]).toMat();
-				if(matlab_img.channels() == 3)
-					cv::cvtColor(matlab_img, matlab_img, cv::COLOR_RGB2BGR);
+				matlabImageToGray(MxArray(prhs[0]), matlab_img);
 			}
 		}
 		else if (MxArray(prhs[1]).isChar())			// Dataset
@@ -103,12 +654,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 			if (nrhs > 4) frame_scale = (float)MxArray(prhs[4]).toDouble();
             if (nrhs > 5) track = MxArray(prhs[3]).toBool();
 		}
+		else if (isImageBatch(MxArray(prhs[1])))	// Matlab image batch
+		{
+			landmarksModelPath = MxArray(prhs[0]).toString();
+			getImageBatch(MxArray(prhs[1]), matlab_imgs);
+
+			track = 0;
+			if (nrhs > 2) frame_scale = (float)MxArray(prhs[2]).toDouble();
+		}
 		else if (MxArray(prhs[1]).isUint8() && MxArray(prhs[1]).ndims() > 1)	// Matlab image
 		{
 			landmarksModelPath = MxArray(prhs[0]).toString();
-			matlab_img = MxArray(prhs[1]).toMat();
-			if (matlab_img.channels() == 3)
-				cv::cvtColor(matlab_img, matlab_img, cv::COLOR_RGB2BGR);
+			matlabImageToGray(MxArray(prhs[1]), matlab_img);
 
 			track = 0;
 			if (nrhs > 2) frame_scale = (float)MxArray(prhs[2]).toDouble();
@@ -122,22 +679,27 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 			g_landmarksModelPath = landmarksModelPath;
 			g_sfl = sfl::SequenceFaceLandmarks::create(landmarksModelPath, frame_scale,
 				(sfl::FaceTrackingType)track);
+			g_sfl_workers.clear();
 		}
-		else g_sfl->clear();
+		else if (g_sfl) g_sfl->clear();
+		else g_sfl = sfl::SequenceFaceLandmarks::create(frame_scale,
+			(sfl::FaceTrackingType)track);
 
 		if (landmarksPath.empty())
 		{
-			if (matlab_img.empty() && (!inputPath.empty() || device >= 0))	// Process sequence
+			if (!matlab_imgs.empty()) processImageBatch(matlab_imgs);	// Process image batch
+			else if (matlab_img.empty() && (!inputPath.empty() || device >= 0))	// Process sequence
 			{
 				// Create video source
-				cv::VideoCapture video_reader;
-				if (device >= 0) video_reader.open(device);
-				else video_reader.open(inputPath);
+				sfl::VideoSource video_source;
+				bool opened = device >= 0 ? video_source.open(device, width, height) :
+					video_source.open(inputPath);
+				if (!opened) throw runtime_error("Failed to open video source!");
 
 				// Main loop
 				cv::Mat frame;
 				int frameCounter = 0, faceCounter = 0;
-				while (video_reader.read(frame))
+				while (video_source.read(frame))
 				{
 					const sfl::Frame& landmarks_frame = g_sfl->addFrame(frame);
 
@@ -169,64 +731,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 			}
 			else g_sfl->addFrame(matlab_img);	// Process matlab image
 		}
-		else g_sfl->load(landmarksPath);
+		else g_sfl->load(landmarksPath, options.first_frame, options.last_frame,
+			options.face_ids);
 
 		///
 		// Output results
 		///
 		const std::list<std::unique_ptr<sfl::Frame>>& sfl_frames = g_sfl->getSequence();
 
-		// Create the frames as a 1-by-n array of structs.
-		mwSize dims[2] = { 1, 1 };
-		dims[1] = sfl_frames.size();
-		const char *frame_fields[] = { "faces", "width", "height" };
-		const char *face_fields[] = { "landmarks", "bbox" };
-		plhs[0] = mxCreateStructArray(2, dims, 3, frame_fields);
-
-		// For each frame
-		std::list<std::unique_ptr<sfl::Frame>>::const_iterator it;
-		size_t i = 0;
-		for (it = sfl_frames.begin(); it != sfl_frames.end(); ++it, ++i)
-		{
-			const std::unique_ptr<sfl::Frame>& sfl_frame = *it;
-
-			// Set the width and height to the fields of the current frame
-			mxSetField(plhs[0], i, frame_fields[1], MxArray(sfl_frame->width));
-			mxSetField(plhs[0], i, frame_fields[2], MxArray(sfl_frame->height));
-
-			const std::list<std::unique_ptr<sfl::Face>>& faces = sfl_frame->faces;
-			if (faces.empty()) continue;
-
-			// Create the faces as a 1-by-n array of structs.
-			dims[1] = faces.size();
-			mxArray* facesStructArray = mxCreateStructArray(2, dims, 2, face_fields);
-
-			// Set the faces to the field of the current frame
-			mxSetField(plhs[0], i, frame_fields[0], facesStructArray);
-
-			// For each face
-			std::list<std::unique_ptr<sfl::Face>>::const_iterator face_it;
-			size_t j = 0;
-			for (face_it = faces.begin(); face_it != faces.end(); ++face_it, ++j)
-			{
-				const std::unique_ptr<sfl::Face>& face = *face_it;
-				//const sfl::Face& face = sfl_frame->faces[j];
-
-				// Convert the landmarks to Matlab's pixel format
-				cv::Mat_<int> landmarks(face->landmarks.size(), 2, (int*)face->landmarks.data());
-				landmarks += 1;
-
-				// Set the landmarks to the field of the current face
-				mxSetField(facesStructArray, j, face_fields[0], MxArray(landmarks));
-
-				// Convert the bounding box to Matlab's pixel format
-				cv::Mat bbox = (cv::Mat_<int>(1, 4) <<
-					face->bbox.x + 1, face->bbox.y + 1, face->bbox.width, face->bbox.height);
-
-				// Set the bounding to the field of the current face
-				mxSetField(facesStructArray, j, face_fields[1], MxArray(bbox));
-			}
-		}
+		// Batches are always returned in the compact format
+		if (options.compact || !matlab_imgs.empty()) plhs[0] = createCompactStruct(sfl_frames);
+		else plhs[0] = createFramesStruct(sfl_frames);
 
 		// Cleanup
 		cv::destroyWindow("find_face_landmarks");
@@ -1,4 +1,6 @@
 #include "sfl/face_tracker.h"
+#include "sfl/motion_model.h"
+#include "sfl/thread_pool.h"
 
 // std
 #include <memory>
@@ -22,12 +24,14 @@ namespace sfl
 		std::vector<int> desc_ind;
 		Face* ref_face;
         cv::Point2f pos;
+        MotionModel motion;
 	};
 
 	class FaceTrackerBRISK : public FaceTracker
 	{
 	protected:
 		int m_id_counter = 0;
+		int m_last_frame_id = -1;
 		cv::Ptr<cv::Feature2D> m_desc_extractor;
 		std::list<std::unique_ptr<TrackedFaceBRISK>> m_tracked_faces;
 		
@@ -37,7 +41,8 @@ namespace sfl
 		}
 
 		FaceTrackerBRISK(const FaceTrackerBRISK& ft) :
-			m_id_counter(ft.m_id_counter), m_desc_extractor(ft.m_desc_extractor)
+			m_id_counter(ft.m_id_counter), m_last_frame_id(ft.m_last_frame_id),
+			m_desc_extractor(ft.m_desc_extractor)
 		{
 			// Deep copy tracked faces
 			for (auto& face : ft.m_tracked_faces)
@@ -53,35 +58,57 @@ namespace sfl
 			else frame_gray = frame;
 
 			// Initialize candidate list
-			std::list<std::unique_ptr<TrackedFaceBRISK>> candidates;
+			std::vector<Face*> faces;
+			faces.reserve(sfl_frame.faces.size());
 			for (auto& face : sfl_frame.faces)
-				candidates.push_back(createTrackedFace(frame_gray, *face, sfl_frame.id));
+				faces.push_back(face.get());
+			std::vector<std::unique_ptr<TrackedFaceBRISK>> created(faces.size());
+			ThreadPool::global().parallelFor(faces.size(), [&](size_t i)
+			{
+				created[i] = createTrackedFace(frame_gray, *faces[i], sfl_frame.id);
+			});
+			std::list<std::unique_ptr<TrackedFaceBRISK>> candidates;
+			for (auto& candidate : created)
+				candidates.push_back(std::move(candidate));
 
 			// For each tracked face
-			double dist, similarity_dist, spatial_dist;
+			const double max_dist = 250.0f;
 			cv::Mat_<double> distances(m_tracked_faces.size(), candidates.size());
-			double* distances_data = (double*)distances.data;
-			std::list<std::unique_ptr<TrackedFaceBRISK>>::iterator best_candidate;
+			std::vector<TrackedFaceBRISK*> tracked_faces, cand_faces;
+			tracked_faces.reserve(m_tracked_faces.size());
 			for (auto& tracked_face : m_tracked_faces)
+				tracked_faces.push_back(tracked_face.get());
+			cand_faces.reserve(candidates.size());
+			for (auto& candidate : candidates)
+				cand_faces.push_back(candidate.get());
+			ThreadPool::global().parallelFor(tracked_faces.size(), [&](size_t i)
 			{
+				TrackedFaceBRISK* tracked_face = tracked_faces[i];
+				cv::Point2f predicted_pos = tracked_face->motion.predictPosition(sfl_frame.id);
+				double gating_radius = tracked_face->motion.getGatingRadius(sfl_frame.id);
+				double* distances_data = distances[(int)i];
+
 				// For each candidate face
-				std::list<std::unique_ptr<TrackedFaceBRISK>>::iterator it;
-				for (it = candidates.begin(); it != candidates.end(); ++it)
+				for (TrackedFaceBRISK* candidate : cand_faces)
 				{
-                    similarity_dist = match(tracked_face.get(), it->get());
-                    spatial_dist = cv::norm(tracked_face->pos - (*it)->pos);
-                    dist = (similarity_dist + spatial_dist)*0.5f;
-					*distances_data++ = dist;
+                    // Skip the descriptors comparison for candidates outside the gate
+                    double spatial_dist = cv::norm(predicted_pos - candidate->pos);
+                    if (spatial_dist > gating_radius)
+                    {
+                        *distances_data++ = max_dist;
+                        continue;
+                    }
+                    double similarity_dist = match(tracked_face, candidate);
+					*distances_data++ = (similarity_dist + spatial_dist)*0.5f;
 				}
-			}
+			});
 
 			// Find matches
 			if (m_tracked_faces.size() > 0)
 			{
 				std::list<std::unique_ptr<TrackedFaceBRISK>>::iterator tracked_it, cand_it;
 				std::list<std::unique_ptr<TrackedFaceBRISK>>::iterator best_tracked_it, best_cand_it;
-				double min_dist = std::numeric_limits<double>::max();
-				const double max_dist = 250.0f;
+				double dist, min_dist = std::numeric_limits<double>::max();
 				int i, j, best_i, best_j;
 				std::vector<std::pair<std::list<std::unique_ptr<TrackedFaceBRISK>>::iterator,
 					std::list<std::unique_ptr<TrackedFaceBRISK>>::iterator>> matches;
@@ -127,6 +154,8 @@ namespace sfl
 					(*match.first)->descriptors = (*match.second)->descriptors;
 					(*match.first)->desc_ind = (*match.second)->desc_ind;
                     (*match.first)->pos = (*match.second)->pos;
+                    (*match.first)->motion.update((*match.second)->pos,
+                        (*match.second)->bbox, sfl_frame.id);
 
 					// Output the tracked id and remove the candidate
 					(*match.second)->ref_face->id = (*match.first)->id;
@@ -143,11 +172,24 @@ namespace sfl
 				(*it)->ref_face->id = (*it)->id;
 				m_tracked_faces.push_back(std::move(*it));
 			}
+
+			m_last_frame_id = sfl_frame.id;
+		}
+
+		void predict(int frame_id, std::vector<cv::Rect>& bboxes) const
+		{
+			bboxes.clear();
+			for (auto& tracked_face : m_tracked_faces)
+			{
+				if (tracked_face->frame_id != m_last_frame_id) continue;
+				bboxes.push_back(tracked_face->motion.predictBBox(frame_id));
+			}
 		}
 
 		void clear()
 		{
 			m_id_counter = 0;
+			m_last_frame_id = -1;
 			m_tracked_faces.clear();
 		}
 
@@ -169,10 +211,8 @@ namespace sfl
 			// Find scale
 			std::vector<cv::KeyPoint> keypoints;
 			cv::Mat mask = cv::Mat_<unsigned char>::zeros(frame_gray.size());
-			cv::Point tl(std::max(face.bbox.tl().x, 0), std::max(face.bbox.tl().y, 0));
-			cv::Point br(std::min(face.bbox.br().x, frame_gray.cols - 1),
-				std::min(face.bbox.br().y, frame_gray.rows - 1));
-			mask(cv::Rect(tl, br)) = 1;
+			cv::Rect roi = face.bbox & cv::Rect(0, 0, frame_gray.cols, frame_gray.rows);
+			if (roi.area() > 0) mask(roi) = 1;
 			m_desc_extractor->detect(frame_gray, keypoints, mask);
 			float scale = 0.0f;
 			for (cv::KeyPoint& kp : keypoints) scale += kp.size;
@@ -208,6 +248,7 @@ namespace sfl
             for (const cv::KeyPoint& kp : tracked_face->landmarks)
                 tracked_face->pos += kp.pt;
             tracked_face->pos /= (float)tracked_face->landmarks.size();
+            tracked_face->motion.init(tracked_face->pos, tracked_face->bbox, _frame_id);
 
 			return tracked_face;
 		}
@@ -1,4 +1,7 @@
 #include "sfl/face_tracker.h"
+#include "sfl/motion_model.h"
+#include "sfl/lbp.h"
+#include "sfl/thread_pool.h"
 #include "sfl/utilities.h"
 
 // std
@@ -6,47 +9,49 @@
 #include <exception>
 #include <numeric>
 #include <set>
+#include <algorithm>
+#include <limits>
 #include <iostream> // Debug
 
 // OpenCV
 #include <opencv2/imgproc.hpp>
 #include <opencv2/features2d.hpp>
 
-#ifdef WITH_OPENCV_CONTRIB
-#include <opencv2/face.hpp>
-#endif
-
 using std::runtime_error;
 
 namespace sfl
 {
-#ifdef WITH_OPENCV_CONTRIB
-
     struct TrackedFaceLBP
     {
         int id;
         int frame_id;
-        cv::Ptr<cv::face::LBPHFaceRecognizer> model;
+        std::vector<cv::Mat> samples;   ///< Ring buffer of the latest LBP histograms
+        size_t next_sample = 0;         ///< Next ring buffer position to write to
         cv::Point2f pos;
+        cv::Rect bbox;
+        MotionModel motion;
         bool tracking_lost = false;
     };
 
     struct CandidateFace
     {
-        cv::Mat frame;
+        cv::Mat hist;
         cv::Point2f pos;
+        cv::Rect bbox;
     };
 
     class FaceTrackerLBP : public FaceTracker
     {
     public:
-        FaceTrackerLBP()
+        FaceTrackerLBP(const FaceTrackerLBPParams& params) : m_params(params)
         {
+            m_params.max_model_samples = std::max(m_params.max_model_samples, 1);
         }
 
         FaceTrackerLBP(const FaceTrackerLBP& ft) :
             m_id_counter(ft.m_id_counter),
-            m_tracking_lost_range(ft.m_tracking_lost_range),
+            m_last_frame_id(ft.m_last_frame_id),
+            m_params(ft.m_params),
             m_verbose(ft.m_verbose)
         {
             // Deep copy tracked faces
@@ -77,7 +82,7 @@ namespace sfl
             // Initialize candidate indices set
             std::set<size_t> cand_indices;
             for (size_t i = 0; i < candidates.size(); ++i)
-                cand_indices.insert(i);
+                if (!candidates[i].hist.empty()) cand_indices.insert(i);
 
             // Matched tracked faces with candidates
             match(m_tracked_faces, candidates, cand_indices, sfl_faces, sfl_frame.id);
@@ -90,7 +95,7 @@ namespace sfl
                 auto it = m_tracked_faces.begin();
                 while (it != m_tracked_faces.end())
                 {
-                    if ((sfl_frame.id - (*it)->frame_id) < m_tracking_lost_range)
+                    if ((sfl_frame.id - (*it)->frame_id) < m_params.tracking_lost_range)
                     {
                         ++it;
                         continue;
@@ -99,11 +104,15 @@ namespace sfl
                     if (m_verbose)
                         std::cout << "Moving face " << (*it)->id << " to lost faces" << std::endl;//
                     (*it)->tracking_lost = true;
+                    createSignature(**it);
                     m_lost_faces.push_back(std::move(*it));
                     it = m_tracked_faces.erase(it);
                 }
             }
 
+            // Evict stale lost faces
+            evictLostFaces(sfl_frame.id);
+
             // Bring back found tracked faces to tracked faces list
             {
                 auto it = m_lost_faces.begin();
@@ -130,12 +139,26 @@ namespace sfl
                     createTrackedFace(candidates[cand_ind], sfl_frame.id));
                 sfl_faces[cand_ind]->id = m_tracked_faces.back()->id;
             }
+
+            m_last_frame_id = sfl_frame.id;
+        }
+
+        void predict(int frame_id, std::vector<cv::Rect>& bboxes) const
+        {
+            bboxes.clear();
+            for (auto& tracked_face : m_tracked_faces)
+            {
+                if (tracked_face->frame_id != m_last_frame_id) continue;
+                bboxes.push_back(tracked_face->motion.predictBBox(frame_id));
+            }
         }
 
         void clear()
         {
             m_id_counter = 0;
+            m_last_frame_id = -1;
             m_tracked_faces.clear();
+            m_lost_faces.clear();
         }
 
         std::shared_ptr<FaceTracker> clone()
@@ -144,6 +167,58 @@ namespace sfl
         }
 
     private:
+        /** Replace a lost face's appearance samples with a single mean histogram.
+        Lost faces are only kept for re-identification, so a compact signature
+        is enough and each of them costs a single comparison per candidate.
+        */
+        void createSignature(TrackedFaceLBP& face) const
+        {
+            if (face.samples.size() <= 1) return;
+            cv::Mat signature = cv::Mat::zeros(face.samples[0].size(), CV_32FC1);
+            for (const cv::Mat& sample : face.samples)
+                signature += sample;
+            signature /= (double)face.samples.size();
+            face.samples = { signature };
+            face.next_sample = 1 % m_params.max_model_samples;
+        }
+
+        /** Remove lost faces that are too old, and the least recently seen
+        lost faces beyond the maximum number of lost faces.
+        */
+        void evictLostFaces(int frame_id)
+        {
+            if (m_params.max_lost_age > 0)
+            {
+                auto it = m_lost_faces.begin();
+                while (it != m_lost_faces.end())
+                {
+                    if ((frame_id - (*it)->frame_id) <= m_params.max_lost_age)
+                    {
+                        ++it;
+                        continue;
+                    }
+
+                    if (m_verbose)
+                        std::cout << "Evicting lost face " << (*it)->id << std::endl;
+                    it = m_lost_faces.erase(it);
+                }
+            }
+
+            if (m_params.max_lost_faces > 0 && (int)m_lost_faces.size() > m_params.max_lost_faces)
+            {
+                // Least recently seen first
+                m_lost_faces.sort([](const std::unique_ptr<TrackedFaceLBP>& f1,
+                    const std::unique_ptr<TrackedFaceLBP>& f2)
+                {return f1->frame_id < f2->frame_id; });
+                while ((int)m_lost_faces.size() > m_params.max_lost_faces)
+                {
+                    if (m_verbose)
+                        std::cout << "Evicting lost face " << m_lost_faces.front()->id << std::endl;
+                    m_lost_faces.pop_front();
+                }
+            }
+        }
+
         void createCandidateFaces(const cv::Mat& frame, const Frame& sfl_frame,
             std::vector<CandidateFace>& candidates) const
         {
@@ -156,22 +231,30 @@ namespace sfl
             else frame_gray = frame;
 
             // For each face
-            candidates.reserve(sfl_frame.faces.size());
+            std::vector<const Face*> faces;
+            faces.reserve(sfl_frame.faces.size());
             for (auto& face : sfl_frame.faces)
+                faces.push_back(face.get());
+            candidates.resize(faces.size());
+            ThreadPool::global().parallelFor(faces.size(), [&](size_t i)
             {
-                CandidateFace candidate;
+                const Face* face = faces[i];
+                CandidateFace& candidate = candidates[i];
 
                 // Calculate frame
                 std::vector<cv::Point> full_face;
                 createFullFace(face->landmarks, full_face);
-                cv::Rect bbox = cv::boundingRect(full_face);
-                bbox.x = std::max(bbox.x, 0);
-                bbox.y = std::max(bbox.y, 0);
-                bbox.width = std::min(bbox.width, frame_gray.cols - bbox.x);
-                bbox.height = std::min(bbox.height, frame_gray.rows - bbox.y);
-                cv::Mat frame_gray_cropped = frame_gray(bbox);
-                cv::resize(frame_gray_cropped, frame_gray_cropped, frame_size);
-                candidate.frame = frame_gray_cropped;
+                cv::Rect bbox = cv::boundingRect(full_face) &
+                    cv::Rect(0, 0, frame_gray.cols, frame_gray.rows);
+                candidate.bbox = face->bbox;
+
+                // Faces with no visible area get no histogram and are not tracked
+                if (bbox.area() > 0)
+                {
+                    cv::Mat frame_gray_cropped = frame_gray(bbox);
+                    cv::resize(frame_gray_cropped, frame_gray_cropped, frame_size);
+                    computeLBPHistogram(frame_gray_cropped, candidate.hist, 3, 8, 8);
+                }
 
                 // Calculate position
                 if (face->landmarks.size() > 0)
@@ -180,8 +263,7 @@ namespace sfl
                         candidate.pos += cv::Point2f((float)p.x, (float)p.y);
                     candidate.pos /= (float)face->landmarks.size();
                 }
-                candidates.push_back(candidate);
-            }
+            });
         }
 
         std::unique_ptr<TrackedFaceLBP> createTrackedFace(
@@ -193,24 +275,58 @@ namespace sfl
             std::unique_ptr<TrackedFaceLBP> tracked_face = std::make_unique<TrackedFaceLBP>();
             tracked_face->id = m_id_counter++;
             tracked_face->frame_id = frame_id;
-            tracked_face->model = cv::face::createLBPHFaceRecognizer(3, 8, 8, 8);
             tracked_face->pos = candidate.pos;
+            tracked_face->bbox = candidate.bbox;
+            tracked_face->motion.init(candidate.pos, candidate.bbox, frame_id);
             tracked_face->tracking_lost = false;
 
-            // Train initial model
-            std::vector<cv::Mat> face_frames = { candidate.frame };
-            std::vector<int> labels = { tracked_face->id };
-            tracked_face->model->train(face_frames, labels);
+            // Initialize appearance model
+            tracked_face->samples.reserve(m_params.max_model_samples);
+            addSample(*tracked_face, candidate.hist);
 
             return tracked_face;
         }
 
-        double calc_dist(const TrackedFaceLBP& face, const CandidateFace& candidate) const
+        /** Add an appearance sample to a tracked face's model.
+        The latest samples are kept in a ring buffer, so the model size and the
+        cost of comparing against it are bounded.
+        */
+        void addSample(TrackedFaceLBP& face, const cv::Mat& hist) const
+        {
+            if (face.samples.size() < (size_t)m_params.max_model_samples)
+                face.samples.push_back(hist);
+            else face.samples[face.next_sample] = hist;
+            face.next_sample = (face.next_sample + 1) % m_params.max_model_samples;
+        }
+
+        /** Calculate the similarity distance between a face's model and a histogram.
+        The distance to the nearest sample is used.
+        */
+        double calc_similarity(const TrackedFaceLBP& face, const cv::Mat& hist) const
+        {
+            double dist, min_dist = std::numeric_limits<double>::max();
+            for (const cv::Mat& sample : face.samples)
+            {
+                dist = compareLBPHistograms(sample, hist);
+                if (dist < min_dist) min_dist = dist;
+            }
+            return min_dist;
+        }
+
+        double calc_dist(const TrackedFaceLBP& face, const CandidateFace& candidate,
+            int frame_id) const
         {
-            int label;
-            double dist, similarity_dist, spatial_dist;
-            face.model->predict(candidate.frame, label, similarity_dist);
-            spatial_dist = cv::norm(face.pos - candidate.pos);
+            double dist, similarity_dist, spatial_dist = 0;
+
+            // Skip the appearance comparison for tracked faces outside the gate
+            if (!face.tracking_lost)
+            {
+                spatial_dist = cv::norm(face.motion.predictPosition(frame_id) - candidate.pos);
+                if (spatial_dist > face.motion.getGatingRadius(frame_id))
+                    return std::numeric_limits<double>::max();
+            }
+
+            similarity_dist = calc_similarity(face, candidate.hist);
             if (!face.tracking_lost && spatial_dist <= 30.0f)
                 dist = (similarity_dist + spatial_dist)*0.5f;
             else dist = similarity_dist;
@@ -219,28 +335,34 @@ namespace sfl
 
         cv::Mat calc_dist(const std::list<std::unique_ptr<TrackedFaceLBP>>& faces,
             const std::vector<CandidateFace>& candidates,
-            std::set<size_t>& cand_indices) const
+            std::set<size_t>& cand_indices, int frame_id) const
         {
             if (faces.empty() || cand_indices.empty()) return cv::Mat();
 
-            cv::Mat dists = cv::Mat_<double>::zeros(faces.size(), candidates.size());
-            double* dists_data = (double*)dists.data;
+            std::vector<const TrackedFaceLBP*> tracked_faces;
+            tracked_faces.reserve(faces.size());
+            for (auto& tracked_face : faces)
+                tracked_faces.push_back(tracked_face.get());
+            std::vector<size_t> cand_vec(cand_indices.begin(), cand_indices.end());
+            cv::Mat dists = cv::Mat_<double>::zeros((int)faces.size(), (int)cand_vec.size());
 
             // For each tracked face
-            for (auto& tracked_face : faces)
+            ThreadPool::global().parallelFor(tracked_faces.size(), [&](size_t i)
             {
+                double* dists_data = dists.ptr<double>((int)i);
+
                 // For each candidate
-                for (size_t cand_ind : cand_indices)
-                    *dists_data++ = calc_dist(*tracked_face, candidates[cand_ind]);
-            }
+                for (size_t cand_ind : cand_vec)
+                    *dists_data++ = calc_dist(*tracked_faces[i], candidates[cand_ind], frame_id);
+            });
 
             if (m_verbose)
             {
-                dists_data = (double*)dists.data;
+                const double* dists_data = (const double*)dists.data;
                 for (auto& tracked_face : faces)
                 {
                     std::cout << "face " << tracked_face->id << ": ";
-                    for (const CandidateFace& cand : candidates)
+                    for (size_t j = 0; j < cand_vec.size(); ++j)
                         std::cout << *dists_data++ << " ";
                     std::cout << std::endl;
                 }
@@ -256,7 +378,7 @@ namespace sfl
             if (cand_indices.empty()) return;
 
             // Get match distances
-            cv::Mat dists = calc_dist(faces, candidates, cand_indices);
+            cv::Mat dists = calc_dist(faces, candidates, cand_indices, frame_id);
             double* dists_data = (double*)dists.data;
 
             // Create index structures
@@ -298,12 +420,12 @@ namespace sfl
                 cand_indices.erase(cand_it);
                 TrackedFaceLBP* tracked_face = tracked_faces[tracked_ind];
                 tracked_face->frame_id = frame_id;
-                //tracked_face->model->clear();
-                std::vector<cv::Mat> train_frames = { candidates[cand_ind].frame };
-                std::vector<int> labels = { tracked_face->id };
-                //tracked_face->model->train(train_frames, labels);
-                tracked_face->model->update(train_frames, labels);
+                addSample(*tracked_face, candidates[cand_ind].hist);
                 tracked_face->pos = candidates[cand_ind].pos;
+                tracked_face->bbox = candidates[cand_ind].bbox;
+                if (tracked_face->tracking_lost)
+                    tracked_face->motion.init(tracked_face->pos, tracked_face->bbox, frame_id);
+                else tracked_face->motion.update(tracked_face->pos, tracked_face->bbox, frame_id);
                 tracked_face->tracking_lost = false;
                 sfl_faces[cand_ind]->id = tracked_face->id;
             }
@@ -311,25 +433,17 @@ namespace sfl
 
     protected:
         int m_id_counter = 0;
-        int m_tracking_lost_range = 10;
+        int m_last_frame_id = -1;
+        FaceTrackerLBPParams m_params;
         bool m_verbose = false;
         std::list<std::unique_ptr<TrackedFaceLBP>> m_tracked_faces;
         std::list<std::unique_ptr<TrackedFaceLBP>> m_lost_faces;
     };
 
-    std::shared_ptr<FaceTracker> createFaceTrackerLBP()
-    {
-        return std::make_shared<FaceTrackerLBP>();
-    }
-
-#else
-    std::shared_ptr<FaceTracker> createFaceTrackerLBP()
+    std::shared_ptr<FaceTracker> createFaceTrackerLBP(const FaceTrackerLBPParams& params)
     {
-        throw std::runtime_error("LBP face tracked is not available!"
-            " Please build with OpenCV's extra modules.");
-        return nullptr;
+        return std::make_shared<FaceTrackerLBP>(params);
     }
-#endif
 
 }   // namespace sfl
 
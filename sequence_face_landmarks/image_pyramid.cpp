@@ -0,0 +1,92 @@
+#include "sfl/image_pyramid.h"
+
+// std
+#include <algorithm>
+
+// OpenCV
+#include <opencv2/imgproc.hpp>
+
+namespace sfl
+{
+    ImagePyramid::ImagePyramid(size_t max_levels) :
+        m_max_levels(std::max(max_levels, (size_t)1))
+    {
+        // References to the levels must stay valid until the next frame
+        m_levels.reserve(m_max_levels);
+    }
+
+    void ImagePyramid::setFrame(const cv::Mat& frame)
+    {
+        m_frame = frame;
+        m_gray_valid = false;
+        for (Level& level : m_levels) level.valid = false;
+    }
+
+    const cv::Mat& ImagePyramid::getLevel(float scale)
+    {
+        if (scale == 1.0f) return m_frame;
+
+        Level& level = findLevel(scale, false);
+        level.last_used = ++m_counter;
+        if (!level.valid)
+        {
+            // Resizing into the existing buffer reuses its allocation
+            cv::resize(m_frame, level.img, cv::Size(), scale, scale);
+            level.valid = true;
+        }
+        return level.img;
+    }
+
+    const cv::Mat& ImagePyramid::getGrayLevel(float scale)
+    {
+        // Grayscale frames are used as is, the buffer must not alias the frame
+        const cv::Mat& gray = m_frame.channels() == 1 ? m_frame : m_gray;
+        if (!m_gray_valid)
+        {
+            if (m_frame.channels() == 3)
+                cv::cvtColor(m_frame, m_gray, cv::COLOR_BGR2GRAY);
+            else if (m_frame.channels() == 4)
+                cv::cvtColor(m_frame, m_gray, cv::COLOR_BGRA2GRAY);
+            m_gray_valid = true;
+        }
+        if (scale == 1.0f) return gray;
+
+        Level& level = findLevel(scale, true);
+        level.last_used = ++m_counter;
+        if (!level.valid)
+        {
+            cv::resize(gray, level.img, cv::Size(), scale, scale);
+            level.valid = true;
+        }
+        return level.img;
+    }
+
+    void ImagePyramid::clear()
+    {
+        m_frame.release();
+        m_gray.release();
+        m_gray_valid = false;
+        m_levels.clear();
+    }
+
+    ImagePyramid::Level& ImagePyramid::findLevel(float scale, bool gray)
+    {
+        for (Level& level : m_levels)
+            if (level.scale == scale && level.gray == gray) return level;
+
+        if (m_levels.size() < m_max_levels)
+        {
+            m_levels.push_back({ scale, gray, cv::Mat(), false, 0 });
+            return m_levels.back();
+        }
+
+        // Replace the least recently used level
+        Level& level = *std::min_element(m_levels.begin(), m_levels.end(),
+            [](const Level& a, const Level& b) { return a.last_used < b.last_used; });
+        level.scale = scale;
+        level.gray = gray;
+        level.valid = false;
+        return level;
+    }
+
+}   // namespace sfl
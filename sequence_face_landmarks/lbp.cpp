@@ -0,0 +1,237 @@
+#include "sfl/lbp.h"
+
+// std
+#include <cmath>
+#include <algorithm>
+#include <cfloat>
+#include <limits>
+#include <stdexcept>
+
+#if CV_SSE2
+#include <emmintrin.h>
+#endif
+
+using std::runtime_error;
+
+const int LBP_NEIGHBORS = 8;
+const int LBP_PATTERNS = 1 << LBP_NEIGHBORS;
+
+namespace sfl
+{
+    /** Bilinear interpolation of a neighbor sample point relative to the center pixel.
+    */
+    struct LBPSample
+    {
+        int fx, fy, cx, cy;
+        float w1, w2, w3, w4;
+    };
+
+    static void computeLBPSamples(int radius, LBPSample* samples)
+    {
+        // Same sample points and weights as OpenCV's extended LBP
+        for (int n = 0; n < LBP_NEIGHBORS; ++n)
+        {
+            LBPSample& s = samples[n];
+            float x = static_cast<float>(radius * cos(2.0*CV_PI*n / static_cast<float>(LBP_NEIGHBORS)));
+            float y = static_cast<float>(-radius * sin(2.0*CV_PI*n / static_cast<float>(LBP_NEIGHBORS)));
+            s.fx = static_cast<int>(std::floor(x));
+            s.fy = static_cast<int>(std::floor(y));
+            s.cx = static_cast<int>(std::ceil(x));
+            s.cy = static_cast<int>(std::ceil(y));
+            float ty = y - s.fy;
+            float tx = x - s.fx;
+            s.w1 = (1 - tx) * (1 - ty);
+            s.w2 = tx * (1 - ty);
+            s.w3 = (1 - tx) * ty;
+            s.w4 = tx * ty;
+        }
+    }
+
+    /** Compute the 8 neighbors extended LBP image.
+    The output is smaller than the input by radius pixels on each side.
+    */
+    static void computeLBP(const cv::Mat& img, cv::Mat& lbp, int radius)
+    {
+        LBPSample samples[LBP_NEIGHBORS];
+        computeLBPSamples(radius, samples);
+        const float eps = std::numeric_limits<float>::epsilon();
+
+        int width = img.cols - 2 * radius;
+        int height = img.rows - 2 * radius;
+        lbp.create(height, width, CV_8UC1);
+
+        // For each row
+        for (int i = 0; i < height; ++i)
+        {
+            const uchar* center = img.ptr<uchar>(i + radius) + radius;
+            const uchar* rows[LBP_NEIGHBORS][4];
+            for (int n = 0; n < LBP_NEIGHBORS; ++n)
+            {
+                const LBPSample& s = samples[n];
+                rows[n][0] = img.ptr<uchar>(i + radius + s.fy) + radius + s.fx;
+                rows[n][1] = img.ptr<uchar>(i + radius + s.fy) + radius + s.cx;
+                rows[n][2] = img.ptr<uchar>(i + radius + s.cy) + radius + s.fx;
+                rows[n][3] = img.ptr<uchar>(i + radius + s.cy) + radius + s.cx;
+            }
+            uchar* dst = lbp.ptr<uchar>(i);
+            int j = 0;
+
+#if CV_SSE2
+            // 16 pixels at a time
+            const __m128i zero = _mm_setzero_si128();
+            const __m128 v_eps = _mm_set1_ps(eps);
+            const __m128 v_abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            for (; j <= width - 16; j += 16)
+            {
+                __m128 c[4], v[4][4];
+                __m128i v_c = _mm_loadu_si128((const __m128i*)(center + j));
+                __m128i c_lo = _mm_unpacklo_epi8(v_c, zero), c_hi = _mm_unpackhi_epi8(v_c, zero);
+                c[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(c_lo, zero));
+                c[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(c_lo, zero));
+                c[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(c_hi, zero));
+                c[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(c_hi, zero));
+
+                __m128i code = zero;
+                for (int n = 0; n < LBP_NEIGHBORS; ++n)
+                {
+                    const LBPSample& s = samples[n];
+                    const __m128 w[4] = { _mm_set1_ps(s.w1), _mm_set1_ps(s.w2),
+                        _mm_set1_ps(s.w3), _mm_set1_ps(s.w4) };
+
+                    // Convert the 4 interpolation taps to float
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        __m128i p = _mm_loadu_si128((const __m128i*)(rows[n][k] + j));
+                        __m128i p_lo = _mm_unpacklo_epi8(p, zero), p_hi = _mm_unpackhi_epi8(p, zero);
+                        v[k][0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(p_lo, zero));
+                        v[k][1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(p_lo, zero));
+                        v[k][2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(p_hi, zero));
+                        v[k][3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(p_hi, zero));
+                    }
+
+                    // Interpolate and compare with the center pixels
+                    __m128i mask[4];
+                    for (int q = 0; q < 4; ++q)
+                    {
+                        __m128 t = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                            _mm_mul_ps(w[0], v[0][q]), _mm_mul_ps(w[1], v[1][q])),
+                            _mm_mul_ps(w[2], v[2][q])), _mm_mul_ps(w[3], v[3][q]));
+                        __m128 d = _mm_and_ps(_mm_sub_ps(t, c[q]), v_abs_mask);
+                        mask[q] = _mm_castps_si128(_mm_or_ps(_mm_cmpgt_ps(t, c[q]),
+                            _mm_cmplt_ps(d, v_eps)));
+                    }
+
+                    // Pack the masks to bytes and set the neighbor's bit
+                    __m128i mask8 = _mm_packs_epi16(_mm_packs_epi32(mask[0], mask[1]),
+                        _mm_packs_epi32(mask[2], mask[3]));
+                    code = _mm_or_si128(code, _mm_and_si128(mask8, _mm_set1_epi8((char)(1 << n))));
+                }
+                _mm_storeu_si128((__m128i*)(dst + j), code);
+            }
+#endif
+
+            // Remaining pixels
+            for (; j < width; ++j)
+            {
+                uchar code = 0;
+                float c = (float)center[j];
+                for (int n = 0; n < LBP_NEIGHBORS; ++n)
+                {
+                    const LBPSample& s = samples[n];
+                    float t = s.w1*rows[n][0][j] + s.w2*rows[n][1][j] +
+                        s.w3*rows[n][2][j] + s.w4*rows[n][3][j];
+                    if (t > c || std::abs(t - c) < eps) code |= (uchar)(1 << n);
+                }
+                dst[j] = code;
+            }
+        }
+    }
+
+    void computeLBPHistogram(const cv::Mat& img, cv::Mat& hist, int radius,
+        int grid_x, int grid_y)
+    {
+        if (img.type() != CV_8UC1)
+            throw runtime_error("LBP histograms require a grayscale image!");
+        if (img.cols <= 2 * radius || img.rows <= 2 * radius)
+            throw runtime_error("The image is too small for the LBP radius!");
+
+        // The LBP image buffer is reused between calls
+        static thread_local cv::Mat lbp;
+        computeLBP(img, lbp, radius);
+
+        hist.create(1, grid_x * grid_y * LBP_PATTERNS, CV_32FC1);
+        hist.setTo(0);
+        int cell_width = lbp.cols / grid_x;
+        int cell_height = lbp.rows / grid_y;
+        if (cell_width == 0 || cell_height == 0) return;
+        double scale = 1.0 / (cell_width * cell_height);
+
+        // For each grid cell
+        int counts[LBP_PATTERNS];
+        float* hist_data = hist.ptr<float>();
+        for (int gy = 0; gy < grid_y; ++gy)
+        {
+            for (int gx = 0; gx < grid_x; ++gx, hist_data += LBP_PATTERNS)
+            {
+                std::fill(counts, counts + LBP_PATTERNS, 0);
+                for (int y = gy * cell_height; y < (gy + 1) * cell_height; ++y)
+                {
+                    const uchar* row = lbp.ptr<uchar>(y) + gx * cell_width;
+                    for (int x = 0; x < cell_width; ++x)
+                        ++counts[row[x]];
+                }
+
+                for (int k = 0; k < LBP_PATTERNS; ++k)
+                    hist_data[k] = (float)(counts[k] * scale);
+            }
+        }
+    }
+
+    double compareLBPHistograms(const cv::Mat& hist1, const cv::Mat& hist2)
+    {
+        if (hist1.type() != CV_32FC1 || hist2.type() != CV_32FC1 ||
+            hist1.total() != hist2.total())
+            throw runtime_error("The histograms must be of the same size and of float type!");
+        if (!hist1.isContinuous() || !hist2.isContinuous())
+            throw runtime_error("The histograms must be continuous!");
+
+        const float* h1 = hist1.ptr<float>();
+        const float* h2 = hist2.ptr<float>();
+        size_t total = hist1.total(), i = 0;
+        double result = 0;
+
+#if CV_SSE2
+        // 8 bins at a time
+        const __m128 v_eps = _mm_set1_ps((float)DBL_EPSILON);
+        const __m128 v_abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+        for (; i + 8 <= total; i += 8)
+        {
+            __m128 a0 = _mm_loadu_ps(h1 + i), b0 = _mm_loadu_ps(h2 + i);
+            __m128 a1 = _mm_loadu_ps(h1 + i + 4), b1 = _mm_loadu_ps(h2 + i + 4);
+            __m128 d0 = _mm_sub_ps(a0, b0), s0 = _mm_add_ps(a0, b0);
+            __m128 d1 = _mm_sub_ps(a1, b1), s1 = _mm_add_ps(a1, b1);
+
+            // Empty bins divide by zero but are masked out
+            __m128 m0 = _mm_cmpgt_ps(_mm_and_ps(s0, v_abs_mask), v_eps);
+            __m128 m1 = _mm_cmpgt_ps(_mm_and_ps(s1, v_abs_mask), v_eps);
+            acc0 = _mm_add_ps(acc0, _mm_and_ps(m0, _mm_div_ps(_mm_mul_ps(d0, d0), s0)));
+            acc1 = _mm_add_ps(acc1, _mm_and_ps(m1, _mm_div_ps(_mm_mul_ps(d1, d1), s1)));
+        }
+        float buf[4];
+        _mm_storeu_ps(buf, _mm_add_ps(acc0, acc1));
+        result = (double)buf[0] + buf[1] + buf[2] + buf[3];
+#endif
+
+        // Remaining bins
+        for (; i < total; ++i)
+        {
+            double a = h1[i] - h2[i];
+            double b = h1[i] + h2[i];
+            if (std::fabs(b) > DBL_EPSILON) result += a*a / b;
+        }
+
+        return 2 * result;
+    }
+
+}   // namespace sfl
@@ -0,0 +1,90 @@
+#include "sfl/motion_model.h"
+
+// std
+#include <cmath>
+#include <algorithm>
+
+// Initial velocity variance [pixels^2 / frame^2]
+const float INITIAL_VELOCITY_VAR = 100.0f;
+
+namespace sfl
+{
+    MotionModel::MotionModel(float process_noise, float measurement_noise) :
+        m_cov(cv::Matx22f::zeros()),
+        m_process_noise(process_noise),
+        m_measurement_noise(measurement_noise)
+    {
+    }
+
+    void MotionModel::init(const cv::Point2f& pos, const cv::Rect& bbox, int frame_id)
+    {
+        m_pos = pos;
+        m_vel = cv::Point2f(0.0f, 0.0f);
+        m_cov = cv::Matx22f(m_measurement_noise, 0.0f, 0.0f, INITIAL_VELOCITY_VAR);
+        m_bbox = bbox;
+        m_frame_id = frame_id;
+        m_initialized = true;
+    }
+
+    void MotionModel::update(const cv::Point2f& pos, const cv::Rect& bbox, int frame_id)
+    {
+        if (!m_initialized || frame_id <= m_frame_id)
+        {
+            init(pos, bbox, frame_id);
+            return;
+        }
+
+        // Predict
+        cv::Point2f pred_pos = predictPosition(frame_id);
+        cv::Matx22f P = predictCovariance(frame_id);
+
+        // Kalman gain for a position only measurement
+        float S = P(0, 0) + m_measurement_noise;
+        float k0 = P(0, 0) / S;
+        float k1 = P(1, 0) / S;
+
+        // Correct
+        cv::Point2f innovation = pos - pred_pos;
+        m_pos = pred_pos + k0 * innovation;
+        m_vel += k1 * innovation;
+        m_cov = cv::Matx22f(
+            (1.0f - k0) * P(0, 0), (1.0f - k0) * P(0, 1),
+            P(1, 0) - k1 * P(0, 0), P(1, 1) - k1 * P(0, 1));
+
+        m_bbox = bbox;
+        m_frame_id = frame_id;
+    }
+
+    cv::Point2f MotionModel::predictPosition(int frame_id) const
+    {
+        float dt = (float)std::max(frame_id - m_frame_id, 0);
+        return m_pos + m_vel * dt;
+    }
+
+    cv::Rect MotionModel::predictBBox(int frame_id) const
+    {
+        cv::Point2f d = predictPosition(frame_id) - m_pos;
+        return m_bbox + cv::Point((int)std::round(d.x), (int)std::round(d.y));
+    }
+
+    float MotionModel::getGatingRadius(int frame_id) const
+    {
+        cv::Matx22f P = predictCovariance(frame_id);
+        float sigma = std::sqrt(P(0, 0) + m_measurement_noise);
+        float half_diag = 0.5f * std::sqrt(float(m_bbox.width * m_bbox.width +
+            m_bbox.height * m_bbox.height));
+        return 3.0f * sigma + half_diag;
+    }
+
+    cv::Matx22f MotionModel::predictCovariance(int frame_id) const
+    {
+        float dt = (float)std::max(frame_id - m_frame_id, 0);
+        float dt2 = dt * dt;
+        cv::Matx22f F(1.0f, dt, 0.0f, 1.0f);
+        cv::Matx22f Q = m_process_noise * cv::Matx22f(
+            dt2 * dt / 3.0f, dt2 / 2.0f,
+            dt2 / 2.0f, dt);
+        return F * m_cov * F.t() + Q;
+    }
+
+}   // namespace sfl
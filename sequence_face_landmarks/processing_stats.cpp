@@ -0,0 +1,138 @@
+#include "sfl/processing_stats.h"
+
+// std
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
+
+namespace sfl
+{
+    const char* getStageName(ProcessingStage stage)
+    {
+        static const char* names[STAGE_COUNT] =
+            { "resize", "detect", "predict", "track", "insert", "total" };
+        return (stage >= 0 && stage < STAGE_COUNT) ? names[stage] : "unknown";
+    }
+
+    void LatencyHistogram::add(double seconds)
+    {
+        double us = seconds * 1e6;
+        int bin = us < 1.0 ? 0 : std::min((int)std::log2(us) + 1, BINS - 1);
+        ++m_bins[bin];
+        m_min = m_count == 0 ? seconds : std::min(m_min, seconds);
+        m_max = std::max(m_max, seconds);
+        m_total += seconds;
+        ++m_count;
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& hist)
+    {
+        if (hist.m_count == 0) return;
+        for (int i = 0; i < BINS; ++i) m_bins[i] += hist.m_bins[i];
+        m_min = m_count == 0 ? hist.m_min : std::min(m_min, hist.m_min);
+        m_max = std::max(m_max, hist.m_max);
+        m_total += hist.m_total;
+        m_count += hist.m_count;
+    }
+
+    void LatencyHistogram::reset()
+    {
+        *this = LatencyHistogram();
+    }
+
+    double LatencyHistogram::percentile(double p) const
+    {
+        if (m_count == 0) return 0.0;
+        size_t rank = (size_t)std::ceil(std::min(std::max(p, 0.0), 100.0) / 100.0 * m_count);
+        size_t accum = 0;
+        for (int i = 0; i < BINS; ++i)
+        {
+            accum += m_bins[i];
+            if (accum >= rank && accum > 0)
+                return std::min(std::ldexp(1e-6, i), m_max);
+        }
+        return m_max;
+    }
+
+    void ProcessingStats::addFrame(size_t num_faces, clock::time_point start,
+        clock::time_point end)
+    {
+        if (frames == 0) first_frame_time = start;
+        last_frame_time = end;
+        stages[STAGE_TOTAL].add(std::chrono::duration<double>(end - start).count());
+        if (face_counts.size() <= num_faces) face_counts.resize(num_faces + 1, 0);
+        ++face_counts[num_faces];
+        faces += num_faces;
+        ++frames;
+    }
+
+    void ProcessingStats::merge(const ProcessingStats& stats)
+    {
+        if (stats.frames == 0) return;
+        for (int i = 0; i < STAGE_COUNT; ++i) stages[i].merge(stats.stages[i]);
+        if (face_counts.size() < stats.face_counts.size())
+            face_counts.resize(stats.face_counts.size(), 0);
+        for (size_t i = 0; i < stats.face_counts.size(); ++i)
+            face_counts[i] += stats.face_counts[i];
+        first_frame_time = frames == 0 ? stats.first_frame_time :
+            std::min(first_frame_time, stats.first_frame_time);
+        last_frame_time = frames == 0 ? stats.last_frame_time :
+            std::max(last_frame_time, stats.last_frame_time);
+        frames += stats.frames;
+        faces += stats.faces;
+    }
+
+    void ProcessingStats::reset()
+    {
+        *this = ProcessingStats();
+    }
+
+    double ProcessingStats::getFPS() const
+    {
+        double seconds = std::chrono::duration<double>(last_frame_time - first_frame_time).count();
+        return seconds > 0 ? frames / seconds : 0.0;
+    }
+
+    double ProcessingStats::getProcessingFPS() const
+    {
+        double seconds = stages[STAGE_TOTAL].total();
+        return seconds > 0 ? frames / seconds : 0.0;
+    }
+
+    void printStats(std::ostream& out, const ProcessingStats& stats)
+    {
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+
+        out << "Frames: " << stats.frames << ", faces: " << stats.faces <<
+            ", faces per frame: " << stats.getFacesPerFrame() <<
+            ", max faces: " << (stats.face_counts.empty() ? 0 : stats.face_counts.size() - 1) << std::endl;
+        out << "FPS: " << stats.getFPS() << ", processing FPS: " <<
+            stats.getProcessingFPS() << std::endl;
+
+        // Latency table [ms]
+        out << std::left << std::setw(10) << "stage" << std::right <<
+            std::setw(10) << "count" << std::setw(12) << "mean ms" <<
+            std::setw(12) << "p50 ms" << std::setw(12) << "p95 ms" <<
+            std::setw(12) << "p99 ms" << std::setw(12) << "max ms" <<
+            std::setw(12) << "total s" << std::endl;
+        for (int i = 0; i < STAGE_COUNT; ++i)
+        {
+            const LatencyHistogram& hist = stats.stages[i];
+            if (hist.count() == 0) continue;
+            out << std::left << std::setw(10) << getStageName((ProcessingStage)i) << std::right <<
+                std::setw(10) << hist.count() <<
+                std::setw(12) << hist.mean() * 1e3 <<
+                std::setw(12) << hist.percentile(50) * 1e3 <<
+                std::setw(12) << hist.percentile(95) * 1e3 <<
+                std::setw(12) << hist.percentile(99) * 1e3 <<
+                std::setw(12) << hist.max() * 1e3 <<
+                std::setw(12) << hist.total() << std::endl;
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}   // namespace sfl
@@ -1,12 +1,19 @@
 #include "sfl/sequence_face_landmarks.h"
 #include "sfl/face_tracker.h"
+#include "sfl/image_pyramid.h"
 
 #ifdef WITH_PROTOBUF
 #include "sequence_face_landmarks.pb.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/wire_format_lite.h>
 #endif // WITH_PROTOBUF
 
 // std
 #include <exception>
+#include <algorithm>
+#include <deque>
+#include <limits>
 
 // Boost
 #include <boost/filesystem.hpp>
@@ -24,6 +31,17 @@ using std::string;
 using std::runtime_error;
 using namespace boost::filesystem;
 
+// Adaptive frame scale
+const int ADAPTIVE_TARGET_FACE_SIZE = 100;	// Smallest face size in the scaled frame [pixels]
+const int ADAPTIVE_HISTORY = 15;			// Number of recent frames with faces considered
+const int ADAPTIVE_MISS_FRAMES = 15;		// Frames without faces before scaling up
+const float ADAPTIVE_MISS_FACTOR = 1.5f;	// Scale up factor after missing faces
+const float ADAPTIVE_HYSTERESIS = 0.25f;	// Minimum relative change for a new scale
+const float ADAPTIVE_SCALE_STEP = 0.125f;	// Scales are rounded to multiples of this step
+
+// Tracking
+const float MIN_PREDICTED_BBOX_VISIBLE = 0.5f;	// Minimum fraction of a predicted box inside the frame
+
 namespace sfl
 {
 	class SequenceFaceLandmarksImpl : public SequenceFaceLandmarks
@@ -31,7 +49,10 @@ namespace sfl
 	public:
 		SequenceFaceLandmarksImpl(const std::string& landmarks_path, float frame_scale,
             FaceTrackingType tracking) :
-			m_frame_scale(frame_scale), m_frame_counter(0), m_tracking(TRACKING_NONE)
+			m_frame_scale(frame_scale), m_frame_counter(0), m_tracking(TRACKING_NONE),
+			m_detection_interval(1), m_frames_since_detection(0), m_stats_enabled(false),
+			m_adaptive_scale(false), m_min_scale(frame_scale), m_max_scale(frame_scale),
+			m_frames_without_faces(0), m_split_resolution(false)
 		{
 			path landmarks(landmarks_path);
 			if (landmarks.extension() == ".pb" || landmarks.extension() == ".lms")
@@ -42,7 +63,10 @@ namespace sfl
 		}
 
 		SequenceFaceLandmarksImpl(float frame_scale, FaceTrackingType tracking) :
-			m_frame_scale(frame_scale), m_frame_counter(0), m_tracking(TRACKING_NONE)
+			m_frame_scale(frame_scale), m_frame_counter(0), m_tracking(TRACKING_NONE),
+			m_detection_interval(1), m_frames_since_detection(0), m_stats_enabled(false),
+			m_adaptive_scale(false), m_min_scale(frame_scale), m_max_scale(frame_scale),
+			m_frames_without_faces(0), m_split_resolution(false)
 		{
 			setTracking(tracking);
 		}
@@ -51,7 +75,14 @@ namespace sfl
 			m_model_path(sfl.m_model_path), m_frame_scale(sfl.m_frame_scale),
 			m_frame_counter(sfl.m_frame_counter), m_tracking(sfl.m_tracking),
 			m_detector(sfl.m_detector), m_pose_model(sfl.m_pose_model),
-            m_input_path(sfl.m_input_path)
+            m_input_path(sfl.m_input_path),
+			m_detection_interval(sfl.m_detection_interval),
+			m_frames_since_detection(sfl.m_frames_since_detection),
+			m_stats_enabled(sfl.m_stats_enabled),
+			m_adaptive_scale(sfl.m_adaptive_scale), m_min_scale(sfl.m_min_scale),
+			m_max_scale(sfl.m_max_scale), m_recent_face_sizes(sfl.m_recent_face_sizes),
+			m_frames_without_faces(sfl.m_frames_without_faces),
+			m_split_resolution(sfl.m_split_resolution), m_lbp_params(sfl.m_lbp_params)
 		{
 			if (sfl.m_face_tracker) m_face_tracker = sfl.m_face_tracker->clone();
 		}
@@ -61,27 +92,71 @@ namespace sfl
 			if (m_model_path.empty())
 				throw runtime_error("A landmarks model file is not set!");
 
+			ProcessingStats::clock::time_point frame_start;
+			if (m_stats_enabled)
+			{
+				m_lap_start = frame_start = ProcessingStats::clock::now();
+				std::fill(m_stage_times, m_stage_times + STAGE_COUNT, -1.0);
+			}
+
 			// Set frame id
 			int frame_id = id;
 			if (id < 0) frame_id = m_frame_counter++;
 			else m_frame_counter = id + 1;
 
-			// Extract landmarks by number of channels
+			// Use the tracker's predicted bounding boxes instead of the detector
+			std::vector<cv::Rect> predicted_bboxes;
+			if (m_tracking != TRACKING_NONE && m_detection_interval > 1 &&
+				++m_frames_since_detection < m_detection_interval)
+			{
+				m_face_tracker->predict(frame_id, predicted_bboxes);
+
+				// Clip the predictions to the frame and drop faces that left it
+				const cv::Rect frame_rect(0, 0, frame.cols, frame.rows);
+				auto it = predicted_bboxes.begin();
+				while (it != predicted_bboxes.end())
+				{
+					cv::Rect clipped = *it & frame_rect;
+					if (clipped.area() <= 0 ||
+						clipped.area() < MIN_PREDICTED_BBOX_VISIBLE * it->area())
+						it = predicted_bboxes.erase(it);
+					else *it++ = clipped;
+				}
+				lap(STAGE_DETECT);
+			}
+			const std::vector<cv::Rect>* bboxes = nullptr;
+			if (!predicted_bboxes.empty()) bboxes = &predicted_bboxes;
+			else m_frames_since_detection = 0;
+
+			// Extract landmarks, the frame is converted to grayscale once for all stages
+			m_pyramid.setFrame(frame);
 			std::unique_ptr<Frame> sfl_frame = std::make_unique<Frame>();
 			sfl_frame->id = frame_id;
 			sfl_frame->width = frame.cols;
 			sfl_frame->height = frame.rows;
-			if (frame.channels() == 3)  // BGR
-				extract_landmarks<dlib::bgr_pixel>(frame, *sfl_frame);
-			else // grayscale
-				extract_landmarks<unsigned char>(frame, *sfl_frame);
+			extract_landmarks(*sfl_frame, bboxes);
 
 			// Track faces if enabled
 			if (m_tracking != TRACKING_NONE)
-				m_face_tracker->addFrame(frame, *sfl_frame);
+			{
+				m_face_tracker->addFrame(m_pyramid.getGrayLevel(1.0f), *sfl_frame);
+				lap(STAGE_TRACK);
+			}
+
+			// Choose the frame scale for the next frame
+			if (m_adaptive_scale) updateAdaptiveScale(*sfl_frame);
 
 			// Save and output current frame
 			m_frames.push_back(std::move(sfl_frame));
+			lap(STAGE_INSERT);
+
+			if (m_stats_enabled)
+			{
+				for (int i = 0; i < STAGE_TOTAL; ++i)
+					if (m_stage_times[i] >= 0) m_stats.stages[i].add(m_stage_times[i]);
+				m_stats.addFrame(m_frames.back()->faces.size(), frame_start, m_lap_start);
+			}
+
 			return *m_frames.back();
 		}
 
@@ -93,6 +168,10 @@ namespace sfl
 		{
 			m_frames.clear();
 			m_frame_counter = 0;
+			m_frames_since_detection = 0;
+			m_recent_face_sizes.clear();
+			m_frames_without_faces = 0;
+			if (m_face_tracker) m_face_tracker->clear();
 		}
 
 		std::shared_ptr<SequenceFaceLandmarks> clone()
@@ -108,47 +187,102 @@ namespace sfl
 
         FaceTrackingType getTracking() const { return m_tracking; }
 
+		int getDetectionInterval() const { return m_detection_interval; }
+
+		const FaceTrackerLBPParams& getTrackerLBPParams() const { return m_lbp_params; }
+
+		const ProcessingStats& getStats() const { return m_stats; }
+
+		bool isStatsEnabled() const { return m_stats_enabled; }
+
+		bool isAdaptiveScale() const { return m_adaptive_scale; }
+
+		bool isSplitResolution() const { return m_split_resolution; }
+
 #ifdef WITH_PROTOBUF
 		void load(const std::string& filePath)
 		{
+			load(filePath, 0, -1, std::vector<int>());
+		}
+
+		void load(const std::string& filePath, int first_frame, int last_frame,
+			const std::vector<int>& face_ids)
+		{
+			using google::protobuf::io::CodedInputStream;
+			using google::protobuf::io::IstreamInputStream;
+			using google::protobuf::internal::WireFormatLite;
 			clear();
+			m_input_path.clear();
 
-			// Read from file
-			io::Sequence sequence;
 			std::ifstream input(filePath, std::ifstream::binary);
-			sequence.ParseFromIstream(&input);
-
-			// Convert format
-            m_input_path = sequence.input_path();
-
-			// For each frame in the sequence
-			for (const io::Frame& io_frame : sequence.frames())
+			if (!input.is_open())
+				throw runtime_error("Failed to open landmarks file: " + filePath);
+			IstreamInputStream zero_copy_input(&input);
+			CodedInputStream coded_input(&zero_copy_input);
+#if GOOGLE_PROTOBUF_VERSION >= 3006000
+			coded_input.SetTotalBytesLimit(std::numeric_limits<int>::max());
+#else
+			coded_input.SetTotalBytesLimit(std::numeric_limits<int>::max(), -1);
+#endif
+
+			// Read the sequence's fields one frame at a time
+			const uint32_t FRAME_TAG = WireFormatLite::MakeTag(
+				io::Sequence::kFramesFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+			const uint32_t INPUT_PATH_TAG = WireFormatLite::MakeTag(
+				io::Sequence::kInputPathFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+			io::Frame io_frame;
+			std::string buffer;
+			uint32_t tag;
+			while ((tag = coded_input.ReadTag()) != 0)
 			{
-				std::unique_ptr<Frame> frame = std::make_unique<Frame>();
-				frame->id = (int)io_frame.id();
-				frame->width = (int)io_frame.width();
-				frame->height = (int)io_frame.height();
-
-				// For each face detected in the frame
-				for (const io::Face& io_face : io_frame.faces())
+				if (tag == INPUT_PATH_TAG)
+				{
+					if (!WireFormatLite::ReadString(&coded_input, &m_input_path))
+						throw runtime_error("Failed to read landmarks file: " + filePath);
+					continue;
+				}
+				if (tag != FRAME_TAG)
 				{
-					std::unique_ptr<Face> face = std::make_unique<Face>();
-					face->id = io_face.id();
-					const io::BoundingBox& io_bbox = io_face.bbox();
-					face->bbox.x = io_bbox.left();
-					face->bbox.y = io_bbox.top();
-					face->bbox.width = io_bbox.width();
-					face->bbox.height = io_bbox.height();
-					face->landmarks.reserve(io_face.landmarks_size());
+					if (!WireFormatLite::SkipField(&coded_input, tag))
+						throw runtime_error("Failed to read landmarks file: " + filePath);
+					continue;
+				}
 
-					// For each landmark point in the face
-					for (const io::Point& io_point : io_face.landmarks())
-						face->landmarks.push_back(cv::Point(io_point.x(), io_point.y()));
+				// Access the frame's bytes in place if they are already buffered
+				uint32_t size;
+				if (!coded_input.ReadVarint32(&size))
+					throw runtime_error("Failed to read landmarks file: " + filePath);
+				const void* data = nullptr;
+				int buffered = 0;
+				bool in_place = coded_input.GetDirectBufferPointer(&data, &buffered) &&
+					buffered >= (int)size;
+				if (!in_place)
+				{
+					if (!coded_input.ReadString(&buffer, (int)size))
+						throw runtime_error("Failed to read landmarks file: " + filePath);
+					data = buffer.data();
+				}
 
-					frame->faces.push_back(std::move(face));
+				// Peek the frame id, fields are serialized in field number order and
+				// proto3 omits zero values
+				int frame_id = 0;
+				{
+					CodedInputStream frame_input((const uint8_t*)data, (int)size);
+					uint32_t id;
+					if (frame_input.ReadTag() == WireFormatLite::MakeTag(
+						io::Frame::kIdFieldNumber, WireFormatLite::WIRETYPE_VARINT) &&
+						frame_input.ReadVarint32(&id))
+						frame_id = (int)id;
 				}
+				if (last_frame >= 0 && frame_id > last_frame) break;
 
-				m_frames.push_back(std::move(frame));
+				if (frame_id >= first_frame)
+				{
+					if (!io_frame.ParseFromArray(data, (int)size))
+						throw runtime_error("Failed to read landmarks file: " + filePath);
+					m_frames.push_back(convertFrame(io_frame, face_ids));
+				}
+				if (in_place) coded_input.Skip((int)size);
 			}
 		}
 
@@ -195,6 +329,8 @@ namespace sfl
 		const std::string NO_PROTOBUF_ERROR =
 			"Method is not implemented! Please enable protobuf to use.";
 		void load(const std::string& filePath) { throw runtime_error(NO_PROTOBUF_ERROR); }
+		void load(const std::string& filePath, int first_frame, int last_frame,
+			const std::vector<int>& face_ids) { throw runtime_error(NO_PROTOBUF_ERROR); }
 		void save(const std::string& filePath) const { throw runtime_error(NO_PROTOBUF_ERROR); }
 #endif // WITH_PROTOBUF
 
@@ -209,7 +345,10 @@ namespace sfl
 			m_detector = dlib::get_frontal_face_detector();
 
 			// Shape predictor for finding landmark positions given an image and face bounding box.
-			dlib::deserialize(modelPath) >> m_pose_model;
+			// The model is immutable after loading so it is shared between clones.
+			std::shared_ptr<dlib::shape_predictor> pose_model = std::make_shared<dlib::shape_predictor>();
+			dlib::deserialize(modelPath) >> *pose_model;
+			m_pose_model = pose_model;
 		}
 
         void setInputPath(const std::string& inputPath) { m_input_path = inputPath; }
@@ -221,50 +360,144 @@ namespace sfl
             if (m_tracking == TRACKING_BRISK)
                 m_face_tracker = createFaceTrackerBRISK();
             else if (m_tracking == TRACKING_LBP)
-                m_face_tracker = createFaceTrackerLBP();
+                m_face_tracker = createFaceTrackerLBP(m_lbp_params);
             else
                 m_face_tracker = nullptr;
 		}
 
+		void setTrackerLBPParams(const FaceTrackerLBPParams& params)
+		{
+			m_lbp_params = params;
+			if (m_tracking == TRACKING_LBP)
+				m_face_tracker = createFaceTrackerLBP(m_lbp_params);
+		}
+
+		void setDetectionInterval(int interval)
+		{
+			m_detection_interval = std::max(interval, 1);
+			m_frames_since_detection = 0;
+		}
+
+		void setStatsEnabled(bool enable) { m_stats_enabled = enable; }
+
+		void setAdaptiveScale(bool enable, float min_scale, float max_scale)
+		{
+			if (min_scale <= 0 || min_scale > max_scale)
+				throw runtime_error("Invalid adaptive frame scale range!");
+			m_adaptive_scale = enable;
+			m_min_scale = min_scale;
+			m_max_scale = max_scale;
+			m_recent_face_sizes.clear();
+			m_frames_without_faces = 0;
+			if (m_adaptive_scale)
+				m_frame_scale = std::min(std::max(m_frame_scale, m_min_scale), m_max_scale);
+		}
+
+		void setSplitResolution(bool enable) { m_split_resolution = enable; }
+
+		void resetStats() { m_stats.reset(); }
+
 		size_t size() const { return m_frames.size(); }
 
 	private:
-		template<typename pixel_type>
-		void extract_landmarks(const cv::Mat& frame, Frame& sfl_frame)
+#ifdef WITH_PROTOBUF
+		std::unique_ptr<Frame> convertFrame(const io::Frame& io_frame,
+			const std::vector<int>& face_ids) const
 		{
-			// Scaling
-			cv::Mat frame_scaled;
-			if (m_frame_scale != 1.0f)
-				cv::resize(frame, frame_scaled, cv::Size(),
-					m_frame_scale, m_frame_scale);
-			else frame_scaled = frame;
+			std::unique_ptr<Frame> frame = std::make_unique<Frame>();
+			frame->id = (int)io_frame.id();
+			frame->width = (int)io_frame.width();
+			frame->height = (int)io_frame.height();
+
+			// For each face detected in the frame
+			for (const io::Face& io_face : io_frame.faces())
+			{
+				if (!face_ids.empty() && std::find(face_ids.begin(), face_ids.end(),
+					(int)io_face.id()) == face_ids.end()) continue;
+				std::unique_ptr<Face> face = std::make_unique<Face>();
+				face->id = io_face.id();
+				const io::BoundingBox& io_bbox = io_face.bbox();
+				face->bbox.x = io_bbox.left();
+				face->bbox.y = io_bbox.top();
+				face->bbox.width = io_bbox.width();
+				face->bbox.height = io_bbox.height();
+				face->landmarks.reserve(io_face.landmarks_size());
+
+				// For each landmark point in the face
+				for (const io::Point& io_point : io_face.landmarks())
+					face->landmarks.push_back(cv::Point(io_point.x(), io_point.y()));
+
+				frame->faces.push_back(std::move(face));
+			}
+
+			return frame;
+		}
+#endif // WITH_PROTOBUF
+
+		void extract_landmarks(Frame& sfl_frame, const std::vector<cv::Rect>* bboxes = nullptr)
+		{
+			// Grayscale conversion and scaling
+			const cv::Mat& frame_scaled = m_pyramid.getGrayLevel(m_frame_scale);
+			lap(STAGE_RESIZE);
 
 			// Convert OpenCV's mat to dlib format 
-			dlib::cv_image<pixel_type> dlib_frame(frame_scaled);
+			dlib::cv_image<unsigned char> dlib_frame(frame_scaled);
 
 			// Detect bounding boxes around all the faces in the image.
-			std::vector<dlib::rectangle> faces = m_detector(dlib_frame);
+			std::vector<dlib::rectangle> faces;
+			if (bboxes == nullptr) faces = m_detector(dlib_frame);
+			else
+			{
+				// Scale the specified bounding boxes to the scaled frame's pixel coordinates
+				faces.reserve(bboxes->size());
+				for (const cv::Rect& bbox : *bboxes)
+				{
+					long left = (long)std::round(bbox.x * m_frame_scale);
+					long top = (long)std::round(bbox.y * m_frame_scale);
+					faces.push_back(dlib::rectangle(left, top,
+						left + (long)std::round(bbox.width * m_frame_scale) - 1,
+						top + (long)std::round(bbox.height * m_frame_scale) - 1));
+				}
+			}
+			lap(STAGE_DETECT);
+
+			// In split resolution mode the landmarks are found in the original frame
+			bool split = m_split_resolution && m_frame_scale != 1.0f;
+			float landmarks_scale = split ? 1.0f : m_frame_scale;
+			dlib::cv_image<unsigned char> dlib_landmarks_frame(
+				split ? m_pyramid.getGrayLevel(1.0f) : frame_scaled);
 
 			// Find the pose of each face we detected.
-			std::vector<dlib::full_object_detection> shapes;
-			//frame_landmarks.faces.resize(faces.size());
 			for (size_t i = 0; i < faces.size(); ++i)
 			{
 				std::unique_ptr<Face> face = std::make_unique<Face>();
-				dlib::rectangle& dlib_face = faces[i];
+				dlib::rectangle dlib_face = faces[i];
+				if (split)
+				{
+					// Map the bounding box to the original frame's pixel coordinates
+					dlib_face = dlib::rectangle(
+						(long)std::round(faces[i].left() / m_frame_scale),
+						(long)std::round(faces[i].top() / m_frame_scale),
+						(long)std::round((faces[i].right() + 1) / m_frame_scale) - 1,
+						(long)std::round((faces[i].bottom() + 1) / m_frame_scale) - 1);
+				}
 
 				// Set face id
 				face->id = i;
 
 				// Set landmarks
-				dlib::full_object_detection shape = m_pose_model(dlib_frame, dlib_face);
+				dlib::full_object_detection shape =
+					(*m_pose_model)(dlib_landmarks_frame, dlib_face);
 				dlib_obj_to_points(shape, face->landmarks);
 
 				// Scale landmarks to the original frame's pixel coordinates
-				for (size_t j = 0; j < face->landmarks.size(); ++j)
+				if (landmarks_scale != 1.0f)
 				{
-					face->landmarks[j].x = (int)std::round(face->landmarks[j].x / m_frame_scale);
-					face->landmarks[j].y = (int)std::round(face->landmarks[j].y / m_frame_scale);
+					for (size_t j = 0; j < face->landmarks.size(); ++j)
+					{
+						face->landmarks[j].x = (int)std::round(face->landmarks[j].x / landmarks_scale);
+						face->landmarks[j].y = (int)std::round(face->landmarks[j].y / landmarks_scale);
+					}
 				}
 
 				// Set face bounding box
@@ -275,6 +508,53 @@ namespace sfl
 
 				sfl_frame.faces.push_back(std::move(face));
 			}
+			lap(STAGE_PREDICT);
+		}
+
+		/** Choose the frame scale from the face sizes in recent frames.
+		The smallest recent face is scaled to the detector's comfortable size, so large
+		faces are processed at a small scale. After several frames without faces the
+		scale is increased to look for small faces.
+		*/
+		void updateAdaptiveScale(const Frame& sfl_frame)
+		{
+			float scale = m_frame_scale;
+			if (sfl_frame.faces.empty())
+			{
+				if (++m_frames_without_faces < ADAPTIVE_MISS_FRAMES) return;
+				m_frames_without_faces = 0;
+				m_recent_face_sizes.clear();
+				scale *= ADAPTIVE_MISS_FACTOR;
+			}
+			else
+			{
+				int min_size = std::numeric_limits<int>::max();
+				for (auto& face : sfl_frame.faces)
+					min_size = std::min(min_size, std::min(face->bbox.width, face->bbox.height));
+				m_frames_without_faces = 0;
+				m_recent_face_sizes.push_back(std::max(min_size, 1));
+				if (m_recent_face_sizes.size() > (size_t)ADAPTIVE_HISTORY)
+					m_recent_face_sizes.pop_front();
+				int smallest = *std::min_element(m_recent_face_sizes.begin(),
+					m_recent_face_sizes.end());
+				scale = (float)ADAPTIVE_TARGET_FACE_SIZE / smallest;
+				if (std::abs(scale / m_frame_scale - 1.0f) < ADAPTIVE_HYSTERESIS) return;
+			}
+
+			scale = std::round(scale / ADAPTIVE_SCALE_STEP) * ADAPTIVE_SCALE_STEP;
+			m_frame_scale = std::min(std::max(scale, m_min_scale), m_max_scale);
+		}
+
+		/** Add the time since the last lap to a processing stage.
+		*/
+		void lap(ProcessingStage stage)
+		{
+			if (!m_stats_enabled) return;
+			ProcessingStats::clock::time_point now = ProcessingStats::clock::now();
+			double& stage_time = m_stage_times[stage];
+			stage_time = std::max(stage_time, 0.0) +
+				std::chrono::duration<double>(now - m_lap_start).count();
+			m_lap_start = now;
 		}
 
 		void dlib_obj_to_points(const dlib::full_object_detection& obj,
@@ -297,11 +577,29 @@ namespace sfl
 		float m_frame_scale;
 		int m_frame_counter;
         FaceTrackingType m_tracking;
+		int m_detection_interval;
+		int m_frames_since_detection;
 		std::shared_ptr<FaceTracker> m_face_tracker;
+		ImagePyramid m_pyramid;
+
+		// Statistics
+		bool m_stats_enabled;
+		ProcessingStats m_stats;
+		ProcessingStats::clock::time_point m_lap_start;
+		double m_stage_times[STAGE_COUNT];
+
+		// Adaptive frame scale
+		bool m_adaptive_scale;
+		float m_min_scale, m_max_scale;
+		std::deque<int> m_recent_face_sizes;
+		int m_frames_without_faces;
+
+		bool m_split_resolution;
+		FaceTrackerLBPParams m_lbp_params;
 
 		// dlib
 		dlib::frontal_face_detector m_detector;
-		dlib::shape_predictor m_pose_model;
+		std::shared_ptr<const dlib::shape_predictor> m_pose_model;
 	};
 
 	std::shared_ptr<SequenceFaceLandmarks> SequenceFaceLandmarks::create(
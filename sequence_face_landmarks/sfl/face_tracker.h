@@ -24,6 +24,12 @@ namespace sfl
 		*/
 		virtual void addFrame(const cv::Mat& frame, Frame& sfl_frame) = 0;
 
+		/** @brief Predict the bounding boxes of the faces tracked in the last added frame.
+		@param frame_id The id of the frame to predict the bounding boxes for.
+		@param bboxes Output predicted bounding boxes in the frame's pixel coordinates.
+		*/
+		virtual void predict(int frame_id, std::vector<cv::Rect>& bboxes) const = 0;
+
 		/** @brief Clear all processed data.
 		*/
 		virtual void clear() = 0;
@@ -39,7 +45,8 @@ namespace sfl
 
     /** @brief Create an instance of the LBP face tracker.
     */
-    std::shared_ptr<FaceTracker> createFaceTrackerLBP();
+    std::shared_ptr<FaceTracker> createFaceTrackerLBP(
+        const FaceTrackerLBPParams& params = FaceTrackerLBPParams());
 
 }   // namespace sfl
 
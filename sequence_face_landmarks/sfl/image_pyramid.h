@@ -0,0 +1,85 @@
+/** @file
+@brief Scaled versions of a frame with persistent buffers.
+*/
+
+#ifndef __SFL_IMAGE_PYRAMID__
+#define __SFL_IMAGE_PYRAMID__
+
+// std
+#include <vector>
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+namespace sfl
+{
+    /** @brief Scaled and grayscale versions of a frame, shared by all the processing
+    stages of the frame.
+    Each level is computed at most once per frame, on first request. The level
+    buffers persist between frames, so frames of the same size are converted without
+    any allocations.
+    */
+    class ImagePyramid
+    {
+    public:
+        /** @brief Create an image pyramid.
+        @param max_levels The maximum number of scaled levels kept. When a new scale is
+        requested and all levels are in use, the least recently used level is replaced.
+        */
+        explicit ImagePyramid(size_t max_levels = 4);
+
+        ImagePyramid(const ImagePyramid&) = delete;
+        ImagePyramid& operator=(const ImagePyramid&) = delete;
+
+        /** @brief Set the frame of the pyramid.
+        The frame is referenced, not copied. All levels are invalidated.
+        */
+        void setFrame(const cv::Mat& frame);
+
+        /** @brief Get the original frame.
+        */
+        const cv::Mat& getFrame() const { return m_frame; }
+
+        /** @brief Get the frame scaled by a factor.
+        The returned image stays valid until the next call to setFrame(), or until
+        more than max_levels different scales were requested for the same frame.
+        @param scale The scale factor. For 1 the original frame is returned.
+        */
+        const cv::Mat& getLevel(float scale);
+
+        /** @brief Get the grayscale frame scaled by a factor.
+        The frame is converted to grayscale once per frame and the scaled grayscale
+        levels are computed from the grayscale frame.
+        The returned image stays valid like the images returned by getLevel().
+        @param scale The scale factor.
+        */
+        const cv::Mat& getGrayLevel(float scale);
+
+        /** @brief Release the frame and all level buffers.
+        */
+        void clear();
+
+    private:
+        struct Level
+        {
+            float scale;
+            bool gray;
+            cv::Mat img;
+            bool valid;
+            size_t last_used;
+        };
+
+        Level& findLevel(float scale, bool gray);
+
+    private:
+        cv::Mat m_frame;
+        cv::Mat m_gray;
+        bool m_gray_valid = false;
+        std::vector<Level> m_levels;
+        size_t m_max_levels;
+        size_t m_counter = 0;
+    };
+
+}   // namespace sfl
+
+#endif	// __SFL_IMAGE_PYRAMID__
@@ -0,0 +1,36 @@
+/** @file
+@brief Local binary patterns histograms.
+*/
+
+#ifndef __SFL_LBP__
+#define __SFL_LBP__
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+namespace sfl
+{
+    /** @brief Compute the spatial histogram of the extended local binary patterns of an image.
+    The patterns are calculated with 8 neighbors sampled on a circle using bilinear interpolation.
+    The result is identical to the histograms calculated by OpenCV's LBPHFaceRecognizer
+    with 8 neighbors.
+    @param img Grayscale image [CV_8UC1].
+    @param hist Output histogram [CV_32FC1, 1 x (grid_x * grid_y * 256)]. The histogram of
+    each grid cell is normalized to sum to 1.
+    @param radius The radius of the circle the neighbors are sampled on.
+    @param grid_x The number of grid cells in the horizontal direction.
+    @param grid_y The number of grid cells in the vertical direction.
+    */
+    void computeLBPHistogram(const cv::Mat& img, cv::Mat& hist, int radius = 3,
+        int grid_x = 8, int grid_y = 8);
+
+    /** @brief Calculate the alternative chi-square distance between two histograms.
+    The result is the same as cv::compareHist with cv::HISTCMP_CHISQR_ALT.
+    @param hist1 First histogram [CV_32FC1].
+    @param hist2 Second histogram [CV_32FC1] with the same number of bins.
+    */
+    double compareLBPHistograms(const cv::Mat& hist1, const cv::Mat& hist2);
+
+}   // namespace sfl
+
+#endif	// __SFL_LBP__
@@ -0,0 +1,82 @@
+/** @file
+@brief Constant velocity motion model for tracked faces.
+*/
+
+#ifndef __SFL_MOTION_MODEL__
+#define __SFL_MOTION_MODEL__
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+namespace sfl
+{
+    /** @brief Constant velocity Kalman filter for a tracked face.
+
+    The face position is filtered with a [position, velocity] state for each
+    axis. Both axes share the same covariance because they are measured together
+    and use the same noise parameters. The bounding box is predicted by moving
+    the last measured bounding box along with the predicted position.
+    */
+    class MotionModel
+    {
+    public:
+        /** @brief Create an uninitialized motion model.
+        @param process_noise Acceleration noise variance [pixels^2 / frame^4].
+        @param measurement_noise Position measurement noise variance [pixels^2].
+        */
+        MotionModel(float process_noise = 1.0f, float measurement_noise = 4.0f);
+
+        /** @brief Initialize the model from a single measurement.
+        The velocity is reset to zero.
+        */
+        void init(const cv::Point2f& pos, const cv::Rect& bbox, int frame_id);
+
+        /** @brief Correct the model with a new measurement.
+        If the model is not initialized, this is equivalent to init().
+        */
+        void update(const cv::Point2f& pos, const cv::Rect& bbox, int frame_id);
+
+        /** @brief Predict the face position in the specified frame.
+        */
+        cv::Point2f predictPosition(int frame_id) const;
+
+        /** @brief Predict the face bounding box in the specified frame.
+        */
+        cv::Rect predictBBox(int frame_id) const;
+
+        /** @brief Get the gating radius in the specified frame [pixels].
+        Measurements farther than this from the predicted position are very unlikely
+        to belong to the face. The radius is 3 standard deviations of the predicted
+        measurement plus half of the bounding box diagonal.
+        */
+        float getGatingRadius(int frame_id) const;
+
+        /** @brief Get the estimated velocity [pixels / frame].
+        */
+        const cv::Point2f& getVelocity() const { return m_vel; }
+
+        /** @brief Get the frame id of the last measurement.
+        */
+        int getFrameID() const { return m_frame_id; }
+
+        /** @brief Return true if the model was initialized with a measurement.
+        */
+        bool isInitialized() const { return m_initialized; }
+
+    private:
+        cv::Matx22f predictCovariance(int frame_id) const;
+
+    private:
+        cv::Point2f m_pos;
+        cv::Point2f m_vel;
+        cv::Matx22f m_cov;
+        cv::Rect m_bbox;
+        int m_frame_id = 0;
+        float m_process_noise;
+        float m_measurement_noise;
+        bool m_initialized = false;
+    };
+
+}   // namespace sfl
+
+#endif	// __SFL_MOTION_MODEL__
@@ -0,0 +1,139 @@
+/** @file
+@brief Processing time statistics.
+*/
+
+#ifndef __SFL_PROCESSING_STATS__
+#define __SFL_PROCESSING_STATS__
+
+// std
+#include <vector>
+#include <array>
+#include <chrono>
+#include <ostream>
+
+namespace sfl
+{
+    /** @brief Represents the processing stages of a frame.
+    */
+    enum ProcessingStage
+    {
+        STAGE_RESIZE = 0,   ///< Frame grayscale conversion and scaling.
+        STAGE_DETECT = 1,   ///< Face detection or bounding box prediction.
+        STAGE_PREDICT = 2,  ///< Landmarks prediction.
+        STAGE_TRACK = 3,    ///< Face tracking.
+        STAGE_INSERT = 4,   ///< Sequence insertion.
+        STAGE_TOTAL = 5,    ///< The entire frame.
+        STAGE_COUNT = 6
+    };
+
+    /** @brief Get the display name of a processing stage.
+    */
+    const char* getStageName(ProcessingStage stage);
+
+    /** @brief Histogram of latencies in logarithmic bins.
+    Bin i holds the latencies in [2^(i-1), 2^i) microseconds, bin 0 holds
+    latencies below one microsecond.
+    */
+    class LatencyHistogram
+    {
+    public:
+        static const int BINS = 32;
+
+        /** @brief Add a latency sample [seconds].
+        */
+        void add(double seconds);
+
+        /** @brief Add all the samples of another histogram.
+        */
+        void merge(const LatencyHistogram& hist);
+
+        /** @brief Remove all samples.
+        */
+        void reset();
+
+        /** @brief Get the number of samples.
+        */
+        size_t count() const { return m_count; }
+
+        /** @brief Get the sum of all samples [seconds].
+        */
+        double total() const { return m_total; }
+
+        /** @brief Get the mean latency [seconds].
+        */
+        double mean() const { return m_count > 0 ? m_total / m_count : 0.0; }
+
+        /** @brief Get the minimum latency [seconds].
+        */
+        double min() const { return m_count > 0 ? m_min : 0.0; }
+
+        /** @brief Get the maximum latency [seconds].
+        */
+        double max() const { return m_max; }
+
+        /** @brief Get an approximated percentile [seconds].
+        @param p The percentile in [0, 100]. The result is the upper bound of the
+        bin that contains it, limited to the maximum latency.
+        */
+        double percentile(double p) const;
+
+        /** @brief Get the number of samples in each bin.
+        */
+        const std::array<size_t, BINS>& bins() const { return m_bins; }
+
+    private:
+        std::array<size_t, BINS> m_bins = {};
+        size_t m_count = 0;
+        double m_total = 0;
+        double m_min = 0;
+        double m_max = 0;
+    };
+
+    /** @brief Processing statistics of a frame sequence.
+    */
+    struct ProcessingStats
+    {
+        typedef std::chrono::steady_clock clock;
+
+        LatencyHistogram stages[STAGE_COUNT];   ///< Latency of each processing stage.
+        std::vector<size_t> face_counts;        ///< Number of frames by the number of faces.
+        size_t frames = 0;                      ///< Number of processed frames.
+        size_t faces = 0;                       ///< Number of found faces.
+        clock::time_point first_frame_time;     ///< Start time of the first frame.
+        clock::time_point last_frame_time;      ///< End time of the last frame.
+
+        /** @brief Add a processed frame.
+        @param num_faces The number of faces found in the frame.
+        @param start The frame's start time.
+        @param end The frame's end time.
+        */
+        void addFrame(size_t num_faces, clock::time_point start, clock::time_point end);
+
+        /** @brief Add the statistics of a sequence that was processed in parallel.
+        */
+        void merge(const ProcessingStats& stats);
+
+        /** @brief Remove all statistics.
+        */
+        void reset();
+
+        /** @brief Get the average number of faces per frame.
+        */
+        double getFacesPerFrame() const { return frames > 0 ? (double)faces / frames : 0.0; }
+
+        /** @brief Get the frame rate including the time between frames [frames / second].
+        */
+        double getFPS() const;
+
+        /** @brief Get the frame rate of the processing time only [frames / second].
+        */
+        double getProcessingFPS() const;
+    };
+
+    /** @brief Print processing statistics in a human readable table.
+    */
+    void printStats(std::ostream& out, const ProcessingStats& stats);
+
+}   // namespace sfl
+
+#endif	// __SFL_PROCESSING_STATS__
@@ -9,6 +9,9 @@
 // OpenCV
 #include <opencv2/core.hpp>
 
+// sfl
+#include "processing_stats.h"
+
 namespace sfl
 {
 	/** @brief Represents a face detected in a frame.
@@ -44,6 +47,16 @@ namespace sfl
         TRACKING_LBP = 2
     };
 
+    /** @brief LBP face tracker parameters.
+    */
+    struct FaceTrackerLBPParams
+    {
+        int tracking_lost_range = 10;   ///< Frames without a match before a tracked face is lost.
+        int max_model_samples = 8;      ///< Appearance samples kept for each tracked face.
+        int max_lost_age = 9000;        ///< Frames a lost face is kept for re-identification [0=unlimited].
+        int max_lost_faces = 64;        ///< Maximum lost faces, least recently seen are evicted first [0=unlimited].
+    };
+
 	/** @brief Interface for sequence face landmarks functionality.
 
 	This class provide face landmarks functionality over a sequence of frames.
@@ -72,8 +85,8 @@ namespace sfl
 		*/
 		virtual void clear() = 0;
 
-		/** @brief Create a full copy, loaded face detector and landmark model 
-		will be shared.
+		/** @brief Create a full copy, loaded landmark model will be shared.
+		Each copy has its own face detector, so copies can process frames in parallel.
 		*/
 		virtual std::shared_ptr<SequenceFaceLandmarks> clone() = 0;
 
@@ -94,10 +107,50 @@ namespace sfl
 		*/
 		virtual FaceTrackingType getTracking() const = 0;
 
+		/** @brief Get the face detection interval [frames].
+		*/
+		virtual int getDetectionInterval() const = 0;
+
+		/** @brief Get the parameters of the LBP face tracker.
+		*/
+		virtual const FaceTrackerLBPParams& getTrackerLBPParams() const = 0;
+
+		/** @brief Get the processing statistics of the frames added since the
+		statistics were enabled or reset.
+		*/
+		virtual const ProcessingStats& getStats() const = 0;
+
+		/** @brief Return true if processing statistics are collected.
+		*/
+		virtual bool isStatsEnabled() const = 0;
+
+		/** @brief Return true if the frame scale is chosen adaptively.
+		*/
+		virtual bool isAdaptiveScale() const = 0;
+
+		/** @brief Return true if the landmarks are found in the original frame
+		instead of the scaled frame.
+		*/
+		virtual bool isSplitResolution() const = 0;
+
 		/** @brief Load a sequence of face landmarks from file.
 		*/
 		virtual void load(const std::string& filePath) = 0;
 
+		/** @brief Load a range of frames of a sequence of face landmarks from file.
+			The frames are stored in increasing id order, so only the frames up to the
+			last frame are read, and the frames before the first frame are skipped
+			without being parsed. The input path is only loaded when the range reaches
+			the end of the sequence.
+		@param filePath Path to the landmarks file (.lms).
+		@param first_frame The id of the first frame to load.
+		@param last_frame The id of the last frame to load. If negative, the frames
+		are loaded up to the end of the sequence.
+		@param face_ids If not empty, only the faces with these ids are loaded.
+		*/
+		virtual void load(const std::string& filePath, int first_frame, int last_frame,
+			const std::vector<int>& face_ids = std::vector<int>()) = 0;
+
 		/** @brief Save current sequence of face landmarks to file.
 		*/
 		virtual void save(const std::string& filePath) const = 0;
@@ -119,6 +172,52 @@ namespace sfl
 			This will keep the face ids consistent in the sequence.
 		*/
 		virtual void setTracking(FaceTrackingType tracking) = 0;
+
+		/** @brief Set the parameters of the LBP face tracker.
+			They are used by the LBP face tracker created by setTracking(). If LBP
+			tracking is already enabled, the tracker is recreated and the faces
+			tracked so far are forgotten.
+		*/
+		virtual void setTrackerLBPParams(const FaceTrackerLBPParams& params) = 0;
+
+		/** @brief Set the face detection interval [frames].
+			When tracking is enabled and the interval is greater than 1, the face detector
+			will only run once every interval frames. In between, the landmarks will be
+			found in the bounding boxes predicted by the face tracker. New faces will only
+			be found in frames where the detector runs.
+		*/
+		virtual void setDetectionInterval(int interval) = 0;
+		
+		/** @brief Enable or disable collecting processing statistics.
+			The statistics include the latency of each processing stage, the number
+			of faces per frame and the frame rate. When disabled, no time is spent on
+			measurements.
+		*/
+		virtual void setStatsEnabled(bool enable) = 0;
+
+		/** @brief Enable or disable split resolution mode.
+			When enabled, faces are detected in the scaled frame and the landmarks are
+			found in the original frame. With a frame scale below 1, the detection cost
+			is reduced without losing landmarks precision.
+		*/
+		virtual void setSplitResolution(bool enable) = 0;
+
+		/** @brief Remove all collected processing statistics.
+		*/
+		virtual void resetStats() = 0;
+
+		/** @brief Enable or disable adaptive frame scale.
+			When enabled, the frame scale is updated after each frame from the face sizes
+			in recent frames: small faces increase the scale and large faces decrease it,
+			so each frame is processed at the cheapest scale that still finds the faces.
+			After several frames without faces the scale is increased to look for small faces.
+			The current scale is returned by getFrameScale().
+		@param enable Enable adaptive frame scale.
+		@param min_scale Minimum frame scale.
+		@param max_scale Maximum frame scale.
+		*/
+		virtual void setAdaptiveScale(bool enable, float min_scale = 0.5f,
+			float max_scale = 2.0f) = 0;
 		
 		/** @brief Get the number of the current frames.
 		*/
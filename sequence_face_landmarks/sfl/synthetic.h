@@ -0,0 +1,53 @@
+/** @file
+@brief Synthetic sequences for reproducible testing and benchmarking.
+*/
+
+#ifndef __SFL_SYNTHETIC__
+#define __SFL_SYNTHETIC__
+
+// sfl
+#include "sequence_face_landmarks.h"
+
+namespace sfl
+{
+    /** @brief Synthetic sequence parameters.
+    */
+    struct SyntheticParams
+    {
+        int frames = 1000;          ///< Number of frames.
+        int width = 1280;           ///< Frame width [pixels].
+        int height = 720;           ///< Frame height [pixels].
+        int faces = 4;              ///< Number of faces in each frame.
+        int min_face_size = 64;     ///< Minimum face bounding box size [pixels].
+        int max_face_size = 192;    ///< Maximum face bounding box size [pixels].
+        float speed = 2.0f;         ///< Maximum face speed [pixels / frame].
+        float churn = 0.0f;         ///< Probability per frame that a face is replaced by a new face.
+        unsigned int seed = 0;      ///< Random seed, the same seed generates the same sequence.
+    };
+
+    /** @brief Generate a synthetic sequence of faces moving across the frame.
+    The faces bounce off the frame's borders. When a face is replaced because of churn,
+    the new face gets a new id and a random position.
+    @param params Sequence parameters.
+    @param sequence The output sequence.
+    */
+    void generateSequence(const SyntheticParams& params,
+        std::list<std::unique_ptr<Frame>>& sequence);
+
+    /** @brief Create 68 synthetic face landmarks inside a bounding box.
+    The points are ordered like dlib's 68 face landmarks model.
+    */
+    void createSyntheticLandmarks(const cv::Rect& bbox, std::vector<cv::Point>& landmarks);
+
+    /** @brief Render a synthetic frame.
+    Each face is rendered as a face-like blob with its features drawn at the
+    face's landmarks, over a noise background.
+    @param frame The frame to render.
+    @param img The output BGR image of the frame's size.
+    @param seed Random seed for the background.
+    */
+    void renderSyntheticFrame(const Frame& frame, cv::Mat& img, unsigned int seed = 0);
+
+}   // namespace sfl
+
+#endif	// __SFL_SYNTHETIC__
@@ -0,0 +1,89 @@
+/** @file
+@brief Thread pool for running tasks in parallel.
+*/
+
+#ifndef __SFL_THREAD_POOL__
+#define __SFL_THREAD_POOL__
+
+// std
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace sfl
+{
+    /** @brief A fixed size pool of worker threads.
+    */
+    class ThreadPool
+    {
+    public:
+        /** @brief Create a thread pool.
+        @param num_threads The number of worker threads. If zero, the number
+        of hardware threads will be used.
+        */
+        explicit ThreadPool(size_t num_threads = 0);
+
+        /** @brief Finish all queued tasks and join the worker threads.
+        */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /** @brief Queue a task for execution by the worker threads.
+        @return A future for the task's result. Exceptions thrown by the task
+        will be rethrown by the future.
+        */
+        template<typename F>
+        std::future<typename std::result_of<F()>::type> enqueue(F&& f)
+        {
+            typedef typename std::result_of<F()>::type result_type;
+            auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(f));
+            std::future<result_type> result = task->get_future();
+            push([task]() { (*task)(); });
+            return result;
+        }
+
+        /** @brief Call fn(i) for each i in [0, n) in parallel and wait for all calls to finish.
+        The calling thread takes part in the work, so this may safely be called
+        from within a task running on the pool. Each index is processed exactly once,
+        so writing the result of each index to its own slot gives deterministic results.
+        The first exception thrown by fn is rethrown after all calls finished.
+        */
+        void parallelFor(size_t n, const std::function<void(size_t)>& fn);
+
+        /** @brief Finish all queued tasks and join the worker threads.
+        Afterwards tasks run in the calling thread. Use it to stop the global pool
+        before the library is unloaded, it must not be called while other threads
+        use the pool.
+        */
+        void shutdown();
+
+        /** @brief Get the number of worker threads.
+        */
+        size_t size() const { return m_workers.size(); }
+
+        /** @brief Get the thread pool shared by the library.
+        */
+        static ThreadPool& global();
+
+    private:
+        void push(std::function<void()> task);
+        void run();
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::queue<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        bool m_stop = false;
+    };
+
+}   // namespace sfl
+
+#endif	// __SFL_THREAD_POOL__
@@ -5,6 +5,9 @@
 #ifndef __SFL_UTILITIES__
 #define __SFL_UTILITIES__
 
+// std
+#include <map>
+
 // sfl
 #include "sequence_face_landmarks.h"
 
@@ -157,6 +160,30 @@ namespace sfl
     void createFullFace(const std::vector<cv::Point>& landmarks,
         std::vector<cv::Point>& full_face);
 
+    /** @brief Match the face ids of a sequence segment that was processed independently
+    to the face ids of a sequence.
+    Faces are matched by the overlap of their bounding boxes in the frames found in both.
+    @param sequence The sequence.
+    @param segment The segment, its first frames may overlap the last frames of the sequence.
+    @param min_iou Minimum intersection over union of bounding boxes for faces to match.
+    @return The sequence id of each matched segment id.
+    */
+    std::map<int, int> matchSegmentIds(const std::list<std::unique_ptr<Frame>>& sequence,
+        const std::list<std::unique_ptr<Frame>>& segment, float min_iou = 0.5f);
+
+    /** @brief Append a sequence segment that was processed independently.
+    The segment's face ids are reconciled with the sequence's face ids using the frames
+    found in both: faces are matched by the overlap of their bounding boxes in these frames.
+    Matched faces take the sequence's ids and unmatched faces get new unique ids.
+    The segment's frames that are already in the sequence are discarded.
+    @param sequence The sequence to append to.
+    @param segment The segment to append, it will be empty on return. Its first frames
+    may overlap the last frames of the sequence.
+    @param min_iou Minimum intersection over union of bounding boxes for faces to match.
+    */
+    void appendSequenceSegment(std::list<std::unique_ptr<Frame>>& sequence,
+        std::list<std::unique_ptr<Frame>>& segment, float min_iou = 0.5f);
+
 	/**	If the specified string is a number in [0, 9] return that number
 	else return -1.
 	*/
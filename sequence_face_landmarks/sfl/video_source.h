@@ -0,0 +1,117 @@
+/** @file
+@brief Video source that decodes frames ahead on a background thread.
+*/
+
+#ifndef __SFL_VIDEO_SOURCE__
+#define __SFL_VIDEO_SOURCE__
+
+// std
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+namespace cv
+{
+    class VideoCapture;
+}
+
+namespace sfl
+{
+    /** @brief Video source that decodes frames ahead of the consumer.
+
+    A decode thread reads frames into a bounded ring of preallocated buffers.
+    When all the buffers are full the decode thread waits for the consumer,
+    so memory usage stays bounded.
+    */
+    class VideoSource
+    {
+    public:
+        /** @brief Create a video source.
+        @param buffer_size The number of frames to decode ahead (minimum 2).
+        */
+        explicit VideoSource(size_t buffer_size = 4);
+
+        /** @brief Stop decoding and close the source.
+        */
+        ~VideoSource();
+
+        VideoSource(const VideoSource&) = delete;
+        VideoSource& operator=(const VideoSource&) = delete;
+
+        /** @brief Open a video file, an image sequence or a device.
+        @param path Path to a video file or an image sequence. If the path is
+        a single digit it will be used as a device id.
+        @param first_frame The index of the first frame to read. Ignored for devices.
+        @return true if the source was opened successfully.
+        */
+        bool open(const std::string& path, int first_frame = 0);
+
+        /** @brief Open a capture device.
+        @param device The device id.
+        @param width Requested frame width [pixels]. Ignored if zero.
+        @param height Requested frame height [pixels]. Ignored if zero.
+        @return true if the device was opened successfully.
+        */
+        bool open(int device, int width = 0, int height = 0);
+
+        /** @brief Stop decoding and close the source.
+        */
+        void close();
+
+        /** @brief Return true if the source is opened.
+        */
+        bool isOpened() const { return m_opened; }
+
+        /** @brief Get the next frame.
+        The frame refers to an internal buffer and stays valid until the next call
+        to read() or close(). Clone it to keep it longer.
+        @return false if there are no more frames.
+        */
+        bool read(cv::Mat& frame);
+
+        /** @brief Get the total number of frames, or zero if unknown.
+        */
+        int getFrameCount() const { return m_frame_count; }
+
+        /** @brief Get the frame rate, or zero if unknown.
+        */
+        double getFPS() const { return m_fps; }
+
+        /** @brief Get the frame size.
+        */
+        const cv::Size& getFrameSize() const { return m_frame_size; }
+
+    private:
+        bool start();
+        void decode();
+
+    private:
+        std::unique_ptr<cv::VideoCapture> m_capture;
+        std::vector<cv::Mat> m_buffers;
+        size_t m_read_pos = 0;      // Next buffer to hand to the consumer
+        size_t m_write_pos = 0;     // Next buffer to decode into
+        size_t m_filled = 0;        // Decoded buffers waiting for the consumer
+        bool m_held = false;        // The consumer holds the previous buffer
+        bool m_eof = false;
+        bool m_stop = false;
+        bool m_opened = false;
+        std::exception_ptr m_error;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+
+        int m_frame_count = 0;
+        double m_fps = 0.0;
+        cv::Size m_frame_size;
+    };
+
+}   // namespace sfl
+
+#endif	// __SFL_VIDEO_SOURCE__
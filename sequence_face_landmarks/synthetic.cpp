@@ -0,0 +1,166 @@
+#include "sfl/synthetic.h"
+
+// std
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+// OpenCV
+#include <opencv2/imgproc.hpp>
+
+using std::runtime_error;
+
+namespace sfl
+{
+    /** A moving synthetic face.
+    */
+    struct SyntheticFace
+    {
+        int id;
+        cv::Point2f pos;    // Top left corner
+        cv::Point2f velocity;
+        int size;
+    };
+
+    static void initFace(SyntheticFace& face, int id, const SyntheticParams& params, cv::RNG& rng)
+    {
+        face.id = id;
+        face.size = rng.uniform(params.min_face_size, params.max_face_size + 1);
+        face.pos.x = rng.uniform(0.0f, (float)std::max(params.width - face.size, 1));
+        face.pos.y = rng.uniform(0.0f, (float)std::max(params.height - face.size, 1));
+        face.velocity.x = rng.uniform(-params.speed, params.speed);
+        face.velocity.y = rng.uniform(-params.speed, params.speed);
+    }
+
+    static void moveFace(SyntheticFace& face, const SyntheticParams& params)
+    {
+        face.pos += face.velocity;
+        float max_x = (float)std::max(params.width - face.size, 0);
+        float max_y = (float)std::max(params.height - face.size, 0);
+        if (face.pos.x < 0 || face.pos.x > max_x)
+        {
+            face.velocity.x = -face.velocity.x;
+            face.pos.x = std::min(std::max(face.pos.x, 0.0f), max_x);
+        }
+        if (face.pos.y < 0 || face.pos.y > max_y)
+        {
+            face.velocity.y = -face.velocity.y;
+            face.pos.y = std::min(std::max(face.pos.y, 0.0f), max_y);
+        }
+    }
+
+    void generateSequence(const SyntheticParams& params,
+        std::list<std::unique_ptr<Frame>>& sequence)
+    {
+        if (params.width <= 0 || params.height <= 0)
+            throw runtime_error("Synthetic frame size must be positive!");
+        if (params.min_face_size <= 0 || params.min_face_size > params.max_face_size)
+            throw runtime_error("Invalid synthetic face size range!");
+
+        sequence.clear();
+        cv::RNG rng(params.seed);
+        std::vector<SyntheticFace> faces(std::max(params.faces, 0));
+        int next_id = 0;
+        for (SyntheticFace& face : faces)
+            initFace(face, next_id++, params, rng);
+
+        for (int i = 0; i < params.frames; ++i)
+        {
+            std::unique_ptr<Frame> frame = std::make_unique<Frame>();
+            frame->id = i;
+            frame->width = params.width;
+            frame->height = params.height;
+
+            for (SyntheticFace& face : faces)
+            {
+                if (i > 0)
+                {
+                    if (params.churn > 0 && rng.uniform(0.0f, 1.0f) < params.churn)
+                        initFace(face, next_id++, params, rng);
+                    else moveFace(face, params);
+                }
+
+                std::unique_ptr<Face> sfl_face = std::make_unique<Face>();
+                sfl_face->id = face.id;
+                sfl_face->bbox = cv::Rect((int)std::round(face.pos.x),
+                    (int)std::round(face.pos.y), face.size, face.size);
+                createSyntheticLandmarks(sfl_face->bbox, sfl_face->landmarks);
+                frame->faces.push_back(std::move(sfl_face));
+            }
+
+            sequence.push_back(std::move(frame));
+        }
+    }
+
+    void createSyntheticLandmarks(const cv::Rect& bbox, std::vector<cv::Point>& landmarks)
+    {
+        landmarks.clear();
+        landmarks.reserve(68);
+        auto add = [&](double x, double y)
+        {
+            landmarks.push_back(cv::Point(bbox.x + (int)std::round(x * bbox.width),
+                bbox.y + (int)std::round(y * bbox.height)));
+        };
+        auto addEllipse = [&](double cx, double cy, double rx, double ry, int n)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                double a = CV_PI + 2 * CV_PI * i / n;
+                add(cx + rx * std::cos(a), cy + ry * std::sin(a));
+            }
+        };
+
+        for (int i = 0; i <= 16; ++i)   // Jaw [0, 16]
+        {
+            double a = CV_PI * (1.0 - i / 16.0);
+            add(0.5 + 0.45 * std::cos(a), 0.35 + 0.6 * std::sin(a));
+        }
+        for (int i = 0; i < 5; ++i)     // Right brow [17, 21]
+            add(0.15 + 0.0625 * i, 0.28 - 0.05 * std::sin(CV_PI * i / 4));
+        for (int i = 0; i < 5; ++i)     // Left brow [22, 26]
+            add(0.6 + 0.0625 * i, 0.28 - 0.05 * std::sin(CV_PI * i / 4));
+        for (int i = 0; i < 4; ++i)     // Nose bridge [27, 30]
+            add(0.5, 0.35 + 0.06 * i);
+        for (int i = 0; i < 5; ++i)     // Nose bottom [31, 35]
+            add(0.4 + 0.05 * i, 0.6 - 0.02 * (i == 2));
+        addEllipse(0.32, 0.4, 0.08, 0.03, 6);   // Right eye [36, 41]
+        addEllipse(0.68, 0.4, 0.08, 0.03, 6);   // Left eye [42, 47]
+        addEllipse(0.5, 0.76, 0.17, 0.07, 12);  // Outer lips [48, 59]
+        addEllipse(0.5, 0.76, 0.1, 0.03, 8);    // Inner lips [60, 67]
+    }
+
+    void renderSyntheticFrame(const Frame& frame, cv::Mat& img, unsigned int seed)
+    {
+        img.create(frame.height, frame.width, CV_8UC3);
+        cv::RNG rng(seed);
+        rng.fill(img, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(96));
+
+        const cv::Scalar skin_color(150, 170, 200), feature_color(40, 40, 60);
+        for (auto& face : frame.faces)
+        {
+            const cv::Rect& bbox = face->bbox;
+            cv::Point center(bbox.x + bbox.width / 2, bbox.y + bbox.height / 2);
+            cv::ellipse(img, center, cv::Size(bbox.width * 9 / 20, bbox.height / 2),
+                0, 0, 360, skin_color, -1);
+            if (face->landmarks.size() != 68) continue;
+
+            // Draw the features along the landmarks
+            const std::vector<cv::Point>& l = face->landmarks;
+            int thickness = std::max(bbox.width / 48, 1);
+            auto polyline = [&](int first, int last, bool closed, bool fill)
+            {
+                std::vector<cv::Point> pts(l.begin() + first, l.begin() + last + 1);
+                if (fill) cv::fillConvexPoly(img, pts, feature_color);
+                else cv::polylines(img, pts, closed, feature_color, thickness);
+            };
+            polyline(17, 21, false, false);     // Right brow
+            polyline(22, 26, false, false);     // Left brow
+            polyline(27, 30, false, false);     // Nose bridge
+            polyline(31, 35, false, false);     // Nose bottom
+            polyline(36, 41, true, true);       // Right eye
+            polyline(42, 47, true, true);       // Left eye
+            polyline(48, 59, true, true);       // Outer lips
+        }
+    }
+
+}   // namespace sfl
@@ -0,0 +1,124 @@
+#include "sfl/thread_pool.h"
+
+// std
+#include <atomic>
+#include <algorithm>
+#include <exception>
+
+namespace sfl
+{
+    ThreadPool::ThreadPool(size_t num_threads)
+    {
+        if (num_threads == 0)
+            num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        m_workers.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i)
+            m_workers.emplace_back(&ThreadPool::run, this);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        shutdown();
+    }
+
+    void ThreadPool::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        for (std::thread& worker : m_workers)
+            worker.join();
+        m_workers.clear();
+    }
+
+    void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& fn)
+    {
+        if (n == 0) return;
+        if (n == 1 || m_workers.empty())
+        {
+            for (size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+
+        struct State
+        {
+            std::atomic<size_t> next{ 0 };
+            std::atomic<size_t> done{ 0 };
+            std::mutex mutex;
+            std::condition_variable cond;
+            std::exception_ptr error;
+        };
+        std::shared_ptr<State> state = std::make_shared<State>();
+
+        // Helpers that start after all indices were taken return immediately
+        // without touching fn, so it's safe to capture it by reference
+        auto work = [state, n, &fn]()
+        {
+            size_t i;
+            while ((i = state->next++) < n)
+            {
+                try { fn(i); }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                }
+                if (++state->done == n)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->cond.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(m_workers.size(), n - 1);
+        for (size_t i = 0; i < helpers; ++i) push(work);
+        work();
+
+        // Wait for the indices taken by the helpers
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cond.wait(lock, [&state, n]() { return state->done == n; });
+        if (state->error) std::rethrow_exception(state->error);
+    }
+
+    ThreadPool& ThreadPool::global()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::push(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_stop)
+            {
+                m_tasks.push(std::move(task));
+                m_cond.notify_one();
+                return;
+            }
+        }
+
+        // The pool was shut down, run the task in the calling thread
+        task();
+    }
+
+    void ThreadPool::run()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+                if (m_stop && m_tasks.empty()) return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+
+}   // namespace sfl
@@ -2,6 +2,7 @@
 
 // std
 #include <map>
+#include <algorithm>
 
 // OpenCV
 #include <opencv2/imgproc.hpp>
@@ -378,5 +379,88 @@ namespace sfl
         if (landmarks[17].x < landmarks[0].x) full_face.push_back(landmarks[17]);
     }
 
+    std::map<int, int> matchSegmentIds(const std::list<std::unique_ptr<Frame>>& sequence,
+        const std::list<std::unique_ptr<Frame>>& segment, float min_iou)
+    {
+        std::map<int, int> id_map;
+        if (sequence.empty()) return id_map;
+
+        // Index the sequence frames that might overlap the segment
+        std::map<int, const Frame*> overlap_frames;
+        int last_id = sequence.back()->id;
+        int first_id = segment.empty() ? last_id + 1 : segment.front()->id;
+        for (auto it = sequence.rbegin(); it != sequence.rend() && (*it)->id >= first_id; ++it)
+            overlap_frames[(*it)->id] = it->get();
+
+        // Accumulate the bounding box overlap of each segment and sequence id pair
+        std::map<std::pair<int, int>, float> votes;
+        for (auto& frame : segment)
+        {
+            if (frame->id > last_id) break;
+            auto overlap_frame = overlap_frames.find(frame->id);
+            if (overlap_frame == overlap_frames.end()) continue;
+            for (auto& seg_face : frame->faces)
+            {
+                for (auto& seq_face : overlap_frame->second->faces)
+                {
+                    float inter = (float)(seg_face->bbox & seq_face->bbox).area();
+                    float iou = inter / (seg_face->bbox.area() + seq_face->bbox.area() - inter);
+                    if (iou >= min_iou) votes[std::make_pair(seg_face->id, seq_face->id)] += iou;
+                }
+            }
+        }
+
+        // Match ids greedily by total overlap
+        std::vector<std::pair<float, std::pair<int, int>>> candidates;
+        candidates.reserve(votes.size());
+        for (auto& vote : votes) candidates.push_back(std::make_pair(vote.second, vote.first));
+        std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<float, std::pair<int, int>>& a,
+                const std::pair<float, std::pair<int, int>>& b) { return a.first > b.first; });
+        std::map<int, int> seq_matched;
+        for (auto& c : candidates)
+        {
+            int seg_id = c.second.first, seq_id = c.second.second;
+            if (id_map.count(seg_id) || seq_matched.count(seq_id)) continue;
+            id_map[seg_id] = seq_id;
+            seq_matched[seq_id] = seg_id;
+        }
+        return id_map;
+    }
+
+    void appendSequenceSegment(std::list<std::unique_ptr<Frame>>& sequence,
+        std::list<std::unique_ptr<Frame>>& segment, float min_iou)
+    {
+        if (sequence.empty())
+        {
+            sequence.splice(sequence.end(), segment);
+            return;
+        }
+        std::map<int, int> id_map = matchSegmentIds(sequence, segment, min_iou);
+        int last_id = sequence.back()->id;
+
+        // Unmatched segment ids get new ids following the sequence's ids
+        int next_id = 0;
+        for (auto& frame : sequence)
+            for (auto& face : frame->faces)
+                next_id = std::max(next_id, face->id + 1);
+
+        // Drop the overlapping frames and relabel the rest
+        while (!segment.empty() && segment.front()->id <= last_id)
+            segment.pop_front();
+        for (auto& frame : segment)
+        {
+            for (auto& face : frame->faces)
+            {
+                auto mapped = id_map.find(face->id);
+                if (mapped == id_map.end())
+                    mapped = id_map.insert(std::make_pair(face->id, next_id++)).first;
+                face->id = mapped->second;
+            }
+        }
+
+        sequence.splice(sequence.end(), segment);
+    }
+
 }   // namespace sfl
 
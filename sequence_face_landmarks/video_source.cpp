@@ -0,0 +1,142 @@
+#include "sfl/video_source.h"
+#include "sfl/utilities.h"
+
+// std
+#include <algorithm>
+
+// OpenCV
+#include <opencv2/videoio.hpp>
+
+namespace sfl
+{
+    VideoSource::VideoSource(size_t buffer_size) :
+        m_capture(new cv::VideoCapture()),
+        m_buffers(std::max(buffer_size, (size_t)2))
+    {
+    }
+
+    VideoSource::~VideoSource()
+    {
+        close();
+    }
+
+    bool VideoSource::open(const std::string& path, int first_frame)
+    {
+        int device = getDeviceID(path);
+        if (device >= 0) return open(device);
+
+        close();
+        if (!m_capture->open(path)) return false;
+        if (first_frame > 0 && !m_capture->set(cv::CAP_PROP_POS_FRAMES, first_frame))
+        {
+            m_capture->release();
+            return false;
+        }
+        return start();
+    }
+
+    bool VideoSource::open(int device, int width, int height)
+    {
+        close();
+        if (!m_capture->open(device)) return false;
+        if (width > 0) m_capture->set(cv::CAP_PROP_FRAME_WIDTH, width);
+        if (height > 0) m_capture->set(cv::CAP_PROP_FRAME_HEIGHT, height);
+        return start();
+    }
+
+    void VideoSource::close()
+    {
+        if (m_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_cond.notify_all();
+            m_thread.join();
+        }
+        m_capture->release();
+        m_opened = false;
+    }
+
+    bool VideoSource::read(cv::Mat& frame)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_opened) return false;
+
+        // Release the buffer returned by the previous call
+        if (m_held)
+        {
+            m_held = false;
+            m_cond.notify_all();
+        }
+
+        m_cond.wait(lock, [this]() { return m_filled > 0 || m_eof; });
+        if (m_filled == 0)
+        {
+            if (m_error) std::rethrow_exception(m_error);
+            return false;
+        }
+
+        frame = m_buffers[m_read_pos];
+        m_read_pos = (m_read_pos + 1) % m_buffers.size();
+        --m_filled;
+        m_held = true;
+        m_cond.notify_all();
+        return true;
+    }
+
+    bool VideoSource::start()
+    {
+        m_frame_count = std::max((int)m_capture->get(cv::CAP_PROP_FRAME_COUNT), 0);
+        m_fps = std::max(m_capture->get(cv::CAP_PROP_FPS), 0.0);
+        m_frame_size.width = (int)m_capture->get(cv::CAP_PROP_FRAME_WIDTH);
+        m_frame_size.height = (int)m_capture->get(cv::CAP_PROP_FRAME_HEIGHT);
+
+        m_read_pos = m_write_pos = m_filled = 0;
+        m_held = m_eof = m_stop = false;
+        m_error = nullptr;
+        m_opened = true;
+        m_thread = std::thread(&VideoSource::decode, this);
+        return true;
+    }
+
+    void VideoSource::decode()
+    {
+        const size_t n = m_buffers.size();
+        while (true)
+        {
+            // Wait for a free buffer
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this, n]()
+                {
+                    return m_stop || (m_filled + (m_held ? 1 : 0)) < n;
+                });
+                if (m_stop) return;
+            }
+
+            // The write buffer is not visible to the consumer, so decode without locking.
+            // Decoding into the same buffer reuses its allocation.
+            bool success = false;
+            try { success = m_capture->read(m_buffers[m_write_pos]); }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!success || m_buffers[m_write_pos].empty())
+            {
+                m_eof = true;
+                m_cond.notify_all();
+                return;
+            }
+            m_write_pos = (m_write_pos + 1) % n;
+            ++m_filled;
+            m_cond.notify_all();
+        }
+    }
+
+}   // namespace sfl
@@ -0,0 +1,243 @@
+// std
+#include <iostream>
+#include <fstream>
+#include <exception>
+#include <chrono>
+#include <mutex>
+#include <future>
+#include <algorithm>
+
+// Boost
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+
+// sfl
+#include <sfl/sequence_face_landmarks.h>
+#include <sfl/thread_pool.h>
+#include <sfl/video_source.h>
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+using std::cout;
+using std::endl;
+using std::cerr;
+using std::string;
+using std::runtime_error;
+using namespace boost::program_options;
+using namespace boost::filesystem;
+
+typedef std::chrono::steady_clock sfl_clock;
+
+struct Job
+{
+	string input_path;
+	string output_path;
+};
+
+struct JobResult
+{
+	int frames = 0;
+	int faces = 0;
+	double seconds = 0;
+	string error;
+};
+
+void addInputPath(const path& input, const std::vector<string>& extensions,
+	std::vector<string>& input_paths)
+{
+	if (is_directory(input))
+	{
+		std::vector<path> files;
+		for (directory_iterator it(input), end; it != end; ++it)
+		{
+			if (!is_regular_file(it->path())) continue;
+			string ext = it->path().extension().string();
+			std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+			if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end())
+				files.push_back(it->path());
+		}
+		std::sort(files.begin(), files.end());
+		for (const path& file : files) input_paths.push_back(file.string());
+	}
+	else if (is_regular_file(input)) input_paths.push_back(input.string());
+	else throw runtime_error("Couldn't find input \"" + input.string() + "\"!");
+}
+
+JobResult processVideo(sfl::SequenceFaceLandmarks& sfl, const Job& job)
+{
+	JobResult result;
+	sfl_clock::time_point start = sfl_clock::now();
+	try
+	{
+		sfl::VideoSource video_source;
+		if (!video_source.open(job.input_path))
+			throw runtime_error("Failed to open video source!");
+
+		cv::Mat frame;
+		while (video_source.read(frame))
+		{
+			const sfl::Frame& landmarks_frame = sfl.addFrame(frame);
+			result.faces += (int)landmarks_frame.faces.size();
+			++result.frames;
+		}
+
+		sfl.setInputPath(job.input_path);
+		sfl.save(job.output_path);
+	}
+	catch (std::exception& e)
+	{
+		result.error = e.what();
+	}
+	result.seconds = std::chrono::duration<double>(sfl_clock::now() - start).count();
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	// Parse command line arguments
+	std::vector<string> inputPaths, extensions;
+	string listPath, outputPath, landmarksModelPath;
+	float frame_scale;
+	unsigned int track, threads;
+	int interval;
+	bool force;
+	try {
+		options_description desc("Allowed options");
+		desc.add_options()
+			("help", "display the help message")
+			("input,i", value<std::vector<string>>(&inputPaths), "paths to video files or directories")
+			("list,f", value<string>(&listPath), "path to a text file listing a video path per line")
+			("output,o", value<string>(&outputPath), "output directory")
+			("landmarks,l", value<string>(&landmarksModelPath)->required(), "path to landmarks model file")
+			("extensions,e", value<std::vector<string>>(&extensions)->default_value(
+				{ ".mp4", ".avi", ".mkv", ".mov" }, "{.mp4 .avi .mkv .mov}"),
+				"video file extensions to process in input directories")
+			("scale,s", value<float>(&frame_scale)->default_value(1.0f), "frame scale")
+			("track,t", value<unsigned int>(&track)->default_value(1),
+				"track faces across frames [0=NONE|1=BRISK|2=LBP]")
+			("interval,n", value<int>(&interval)->default_value(1),
+				"face detection interval while tracking [frames]")
+			("threads,j", value<unsigned int>(&threads)->default_value(0),
+				"number of videos to process in parallel (0 = number of hardware threads)")
+			("force", bool_switch(&force), "process inputs even if their landmarks are up to date")
+			;
+		variables_map vm;
+		store(command_line_parser(argc, argv).options(desc).
+			positional(positional_options_description().add("input", -1)).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: sfl_batch [options]" << endl;
+			cout << desc << endl;
+			exit(0);
+		}
+		notify(vm);
+		if (inputPaths.empty() && listPath.empty()) throw error("no input was specified!");
+		if (!is_regular_file(landmarksModelPath)) throw error("landmarks must be a path to a file!");
+		if (!outputPath.empty() && !is_directory(outputPath)) throw error("output must be a directory!");
+	}
+	catch (const error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		exit(1);
+	}
+
+	try
+	{
+		// Collect input paths
+		for (string& ext : extensions)
+		{
+			if (!ext.empty() && ext[0] != '.') ext = "." + ext;
+			std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+		}
+		std::vector<string> videoPaths;
+		for (const string& inputPath : inputPaths)
+			addInputPath(inputPath, extensions, videoPaths);
+		if (!listPath.empty())
+		{
+			std::ifstream list(listPath);
+			if (!list.is_open()) throw runtime_error("Failed to open list file \"" + listPath + "\"!");
+			string line;
+			while (std::getline(list, line))
+			{
+				line.erase(line.find_last_not_of(" \t\r\n") + 1);
+				if (line.empty() || line[0] == '#') continue;
+				addInputPath(line, extensions, videoPaths);
+			}
+		}
+
+		// Create jobs, skip inputs with up to date landmarks
+		std::vector<Job> jobs;
+		int skipped = 0;
+		for (const string& videoPath : videoPaths)
+		{
+			path input(videoPath);
+			path output = outputPath.empty() ? input.parent_path() : path(outputPath);
+			output /= (input.stem() += ".lms");
+			if (!force && is_regular_file(output) &&
+				last_write_time(output) >= last_write_time(input))
+			{
+				++skipped;
+				continue;
+			}
+			jobs.push_back({ videoPath, output.string() });
+		}
+		cout << "Found " << videoPaths.size() << " videos, " << skipped <<
+			" already up to date." << endl;
+		if (jobs.empty()) return 0;
+
+		// Initialize Sequence Face Landmarks once, each job will use a copy
+		std::shared_ptr<sfl::SequenceFaceLandmarks> sfl =
+			sfl::SequenceFaceLandmarks::create(landmarksModelPath, frame_scale,
+			(sfl::FaceTrackingType)track);
+		sfl->setDetectionInterval(interval);
+
+		// Process the videos in parallel
+		sfl::ThreadPool pool(threads);
+		std::mutex output_mutex;
+		int completed = 0;
+		sfl_clock::time_point start = sfl_clock::now();
+		std::vector<std::future<JobResult>> results;
+		results.reserve(jobs.size());
+		for (const Job& job : jobs)
+		{
+			results.push_back(pool.enqueue([&, job]()
+			{
+				std::shared_ptr<sfl::SequenceFaceLandmarks> job_sfl = sfl->clone();
+				JobResult result = processVideo(*job_sfl, job);
+
+				std::lock_guard<std::mutex> lock(output_mutex);
+				cout << "[" << ++completed << "/" << jobs.size() << "] " << job.input_path;
+				if (result.error.empty())
+					cout << (boost::format(": %d frames, %d faces, %.1f fps") % result.frames %
+						result.faces % (result.frames / std::max(result.seconds, 1e-6))) << endl;
+				else cout << ": " << result.error << endl;
+				return result;
+			}));
+		}
+
+		// Summary
+		int failed = 0, total_frames = 0, total_faces = 0;
+		for (std::future<JobResult>& result : results)
+		{
+			JobResult r = result.get();
+			if (!r.error.empty()) ++failed;
+			total_frames += r.frames;
+			total_faces += r.faces;
+		}
+		double seconds = std::chrono::duration<double>(sfl_clock::now() - start).count();
+		cout << (boost::format("Processed %d videos (%d failed, %d skipped) using %d threads in %.1f seconds.") %
+			jobs.size() % failed % skipped % pool.size() % seconds) << endl;
+		cout << (boost::format("Throughput: %.1f frames/s, %.2f videos/min, %d faces found.") %
+			(total_frames / std::max(seconds, 1e-6)) % (jobs.size() * 60.0 / std::max(seconds, 1e-6)) %
+			total_faces) << endl;
+		if (failed > 0) return 1;
+	}
+	catch (std::exception& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,198 @@
+// std
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <exception>
+
+// Boost
+#include <boost/filesystem.hpp>
+
+// sfl
+#include <sfl/sequence_face_landmarks.h>
+#include <sfl/face_tracker.h>
+#include <sfl/utilities.h>
+#include <sfl/synthetic.h>
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+// Benchmark
+#include <benchmark/benchmark.h>
+
+using std::string;
+using namespace boost::filesystem;
+
+/** Create a sequence of frames with faces moving across the frame.
+*/
+void createSequence(int num_frames, int num_faces,
+    std::list<std::unique_ptr<sfl::Frame>>& sequence)
+{
+    sfl::SyntheticParams params;
+    params.frames = num_frames;
+    params.faces = num_faces;
+    params.max_face_size = std::max(params.min_face_size,
+        std::min(params.max_face_size, 2 * params.height / std::max((int)std::ceil(std::sqrt(num_faces)), 1)));
+    sfl::generateSequence(params, sequence);
+}
+
+/** Copy a frame's faces into a new frame.
+*/
+std::unique_ptr<sfl::Frame> copyFrame(const sfl::Frame& frame)
+{
+    std::unique_ptr<sfl::Frame> copy = std::make_unique<sfl::Frame>();
+    copy->id = frame.id;
+    copy->width = frame.width;
+    copy->height = frame.height;
+    for (auto& face : frame.faces)
+        copy->faces.push_back(std::make_unique<sfl::Face>(*face));
+    return copy;
+}
+
+/** Create a temporary file path that is removed on destruction.
+*/
+struct TempPath
+{
+    path p = temp_directory_path() / unique_path("sfl_bench_%%%%-%%%%.lms");
+    ~TempPath() { boost::system::error_code ec; remove(p, ec); }
+};
+
+static void BM_AddFrame(benchmark::State& state)
+{
+    const char* model_path = std::getenv("SFL_LANDMARKS_MODEL");
+    if (model_path == nullptr)
+    {
+        state.SkipWithError("SFL_LANDMARKS_MODEL is not set to a landmarks model file");
+        return;
+    }
+    float frame_scale = state.range(0) / 100.0f;
+    std::shared_ptr<sfl::SequenceFaceLandmarks> sfl =
+        sfl::SequenceFaceLandmarks::create(model_path, frame_scale);
+    std::list<std::unique_ptr<sfl::Frame>> sequence;
+    createSequence(1, (int)state.range(1), sequence);
+    cv::Mat img;
+    sfl::renderSyntheticFrame(*sequence.front(), img);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sfl->addFrame(img));
+        sfl->clear();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddFrame)->ArgNames({ "scale%", "faces" })
+    ->Args({ 50, 1 })->Args({ 100, 1 })->Args({ 150, 1 })->Args({ 200, 1 })
+    ->Args({ 100, 10 })->Unit(benchmark::kMillisecond);
+
+template<sfl::FaceTrackingType tracking>
+static void BM_Tracker(benchmark::State& state)
+{
+    int num_faces = (int)state.range(0);
+    std::shared_ptr<sfl::FaceTracker> tracker = tracking == sfl::TRACKING_BRISK ?
+        sfl::createFaceTrackerBRISK() : sfl::createFaceTrackerLBP();
+
+    // Prepare a short loop of frames
+    const int loop_frames = 16;
+    std::list<std::unique_ptr<sfl::Frame>> sequence;
+    createSequence(loop_frames, num_faces, sequence);
+    std::vector<const sfl::Frame*> frames;
+    std::vector<cv::Mat> images(loop_frames);
+    for (auto& frame : sequence)
+    {
+        sfl::renderSyntheticFrame(*frame, images[frames.size()]);
+        frames.push_back(frame.get());
+    }
+
+    int frame_id = 0;
+    for (auto _ : state)
+    {
+        int i = frame_id % loop_frames;
+        std::unique_ptr<sfl::Frame> frame = copyFrame(*frames[i]);
+        frame->id = frame_id++;
+        tracker->addFrame(images[i], *frame);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Tracker, sfl::TRACKING_BRISK)->ArgName("faces")
+    ->Arg(1)->Arg(10)->Arg(50)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Tracker, sfl::TRACKING_LBP)->ArgName("faces")
+    ->Arg(1)->Arg(10)->Arg(50)->Unit(benchmark::kMillisecond);
+
+static void BM_Save(benchmark::State& state)
+{
+    std::shared_ptr<sfl::SequenceFaceLandmarks> sfl = sfl::SequenceFaceLandmarks::create();
+    createSequence((int)state.range(0), 1, sfl->getSequenceMutable());
+    TempPath temp;
+
+    try
+    {
+        for (auto _ : state)
+            sfl->save(temp.p.string());
+    }
+    catch (std::exception& e)
+    {
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * (int64_t)file_size(temp.p));
+}
+BENCHMARK(BM_Save)->ArgName("frames")->RangeMultiplier(10)->Range(1000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_Load(benchmark::State& state)
+{
+    std::shared_ptr<sfl::SequenceFaceLandmarks> sfl = sfl::SequenceFaceLandmarks::create();
+    createSequence((int)state.range(0), 1, sfl->getSequenceMutable());
+    TempPath temp;
+
+    try
+    {
+        sfl->save(temp.p.string());
+        for (auto _ : state)
+            sfl->load(temp.p.string());
+    }
+    catch (std::exception& e)
+    {
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * (int64_t)file_size(temp.p));
+}
+BENCHMARK(BM_Load)->ArgName("frames")->RangeMultiplier(10)->Range(1000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_GetSequenceStats(benchmark::State& state)
+{
+    std::list<std::unique_ptr<sfl::Frame>> sequence;
+    createSequence((int)state.range(0), 4, sequence);
+    std::vector<sfl::FaceStat> stats;
+
+    for (auto _ : state)
+    {
+        sfl::getSequenceStats(sequence, stats);
+        benchmark::DoNotOptimize(stats.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetSequenceStats)->ArgName("frames")->RangeMultiplier(10)->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_Render(benchmark::State& state)
+{
+    std::list<std::unique_ptr<sfl::Frame>> sequence;
+    createSequence(1, (int)state.range(0), sequence);
+    cv::Mat img, render_img;
+    sfl::renderSyntheticFrame(*sequence.front(), img);
+
+    for (auto _ : state)
+    {
+        img.copyTo(render_img);
+        sfl::render(render_img, *sequence.front());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Render)->ArgName("faces")->Arg(1)->Arg(10)->Arg(50)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -1,6 +1,7 @@
 // std
 #include <iostream>
 #include <exception>
+#include <algorithm>
 
 // Boost
 #include <boost/program_options.hpp>
@@ -10,6 +11,8 @@
 // sfl
 #include <sfl/sequence_face_landmarks.h>
 #include <sfl/utilities.h>
+#include <sfl/video_source.h>
+#include <sfl/thread_pool.h>
 
 // OpenCV
 #include <opencv2/core.hpp>
@@ -24,13 +27,76 @@ using std::runtime_error;
 using namespace boost::program_options;
 using namespace boost::filesystem;
 
+/** Process a video in parallel segments and stitch the results.
+Each segment is extended by overlap frames into the next segment.
+The processing statistics of all segments are merged into stats.
+Returns the number of faces found.
+*/
+int processSegments(sfl::SequenceFaceLandmarks& sfl, const string& inputPath,
+	int segments, int overlap, sfl::ProcessingStats& stats)
+{
+	// Get the total number of frames
+	int total_frames = 0;
+	{
+		sfl::VideoSource video_source;
+		if (!video_source.open(inputPath))
+			throw runtime_error("Failed to open video source!");
+		total_frames = video_source.getFrameCount();
+	}
+	if (total_frames <= 0)
+		throw runtime_error("Processing in segments requires a known number of frames!");
+	segments = std::min(segments, total_frames);
+
+	// Process each segment with an independent copy
+	sfl.clear();
+	std::vector<std::shared_ptr<sfl::SequenceFaceLandmarks>> segment_sfls(segments);
+	for (auto& segment_sfl : segment_sfls) segment_sfl = sfl.clone();
+	// A dedicated pool keeps the segments off the library's pool used by the trackers
+	sfl::ThreadPool pool(segments);
+	pool.parallelFor(segments, [&](size_t i)
+	{
+		int first = (int)(i * total_frames / segments);
+		int last = (int)((i + 1) * total_frames / segments) + overlap;
+		sfl::VideoSource video_source;
+		if (!video_source.open(inputPath, first))
+			throw runtime_error("Failed to seek video source!");
+		cv::Mat frame;
+		for (int id = first; id < last && video_source.read(frame); ++id)
+			segment_sfls[i]->addFrame(frame, id);
+	});
+
+	// Stitch the segments
+	std::list<std::unique_ptr<sfl::Frame>>& sequence = sfl.getSequenceMutable();
+	for (auto& segment_sfl : segment_sfls)
+	{
+		stats.merge(segment_sfl->getStats());
+		std::list<std::unique_ptr<sfl::Frame>>& segment = segment_sfl->getSequenceMutable();
+		if (sfl.getTracking() != sfl::TRACKING_NONE)
+			sfl::appendSequenceSegment(sequence, segment);
+		else
+		{
+			// Without tracking the face ids are per frame so only the overlap is dropped
+			while (!sequence.empty() && !segment.empty() &&
+				segment.front()->id <= sequence.back()->id)
+				segment.pop_front();
+			sequence.splice(sequence.end(), segment);
+		}
+	}
+
+	int faceCounter = 0;
+	for (auto& frame : sequence) faceCounter += (int)frame->faces.size();
+	return faceCounter;
+}
+
 int main(int argc, char* argv[])
 {
 	// Parse command line arguments
 	string inputPath, outputPath, landmarksModelPath;
 	std::vector<float> frame_scales;
     unsigned int track;
-	bool preview;
+	int interval, segments, overlap;
+	sfl::FaceTrackerLBPParams lbp_params;
+	bool preview, stats, adaptive, split;
 	try {
 		options_description desc("Allowed options");
 		desc.add_options()
@@ -42,7 +108,22 @@ int main(int argc, char* argv[])
 				"frame scales for finding small faces. Best scale will be selected")
 			("track,t", value<unsigned int>(&track)->default_value(1), 
                 "track faces across frames [0=NONE|1=BRISK|2=LBP]")
+			("interval,n", value<int>(&interval)->default_value(1),
+				"face detection interval while tracking [frames]")
+			("lost_age", value<int>(&lbp_params.max_lost_age)->default_value(lbp_params.max_lost_age),
+				"frames a lost face is kept for re-identification by the LBP tracker [0=unlimited]")
+			("lost_faces", value<int>(&lbp_params.max_lost_faces)->default_value(lbp_params.max_lost_faces),
+				"maximum lost faces kept by the LBP tracker [0=unlimited]")
+			("segments,g", value<int>(&segments)->default_value(1),
+				"number of video segments to process in parallel, disables preview")
+			("overlap", value<int>(&overlap)->default_value(30),
+				"frames shared by consecutive segments for matching face ids")
 			("preview,p", value<bool>(&preview)->default_value(true), "preview landmarks")
+			("stats", bool_switch(&stats), "print processing statistics")
+			("adaptive,a", bool_switch(&adaptive),
+				"choose the frame scale per frame, within the range of the specified scales")
+			("split", bool_switch(&split),
+				"detect faces in the scaled frame and find landmarks in the original frame")
 			;
 		variables_map vm;
 		store(command_line_parser(argc, argv).options(desc).
@@ -67,7 +148,19 @@ int main(int argc, char* argv[])
 		std::vector<std::shared_ptr<sfl::SequenceFaceLandmarks>> sfls(frame_scales.size());
 		sfls[0] = sfl::SequenceFaceLandmarks::create(landmarksModelPath, frame_scales[0],
             (sfl::FaceTrackingType)track);
-		for (int i = 1; i < frame_scales.size(); ++i)
+		sfls[0]->setTrackerLBPParams(lbp_params);
+		sfls[0]->setDetectionInterval(interval);
+		sfls[0]->setStatsEnabled(stats);
+		sfls[0]->setSplitResolution(split);
+		if (adaptive)
+		{
+			// The scales define the adaptive range instead of a sweep
+			auto range = std::minmax_element(frame_scales.begin(), frame_scales.end());
+			if (frame_scales.size() > 1) sfls[0]->setAdaptiveScale(true, *range.first, *range.second);
+			else sfls[0]->setAdaptiveScale(true);
+			sfls.resize(1);
+		}
+		for (size_t i = 1; i < sfls.size(); ++i)
 		{
 			sfls[i] = sfls[0]->clone();
 			sfls[i]->setFrameScale(frame_scales[i]);
@@ -75,47 +168,57 @@ int main(int argc, char* argv[])
 
 		int max_faces = 0;
 		std::shared_ptr<sfl::SequenceFaceLandmarks> best_sfl;
+		sfl::ProcessingStats best_stats;
 
 		// For each sfl configuration
 		for (auto& sfl : sfls)
 		{
-			// Create video source
-			cv::VideoCapture video_reader(inputPath);
-
-			// Main loop
-			cv::Mat frame;
-			int frameCounter = 0, faceCounter = 0;
-			while (video_reader.read(frame))
+			int faceCounter = 0;
+			sfl::ProcessingStats segment_stats;
+			if (segments > 1)
+				faceCounter = processSegments(*sfl, inputPath, segments, overlap, segment_stats);
+			else
 			{
-				const sfl::Frame& landmarks_frame = sfl->addFrame(frame);
-                faceCounter += landmarks_frame.faces.size();
+				// Create video source
+				sfl::VideoSource video_source;
+				if (!video_source.open(inputPath))
+					throw runtime_error("Failed to open video source!");
 
-				if (preview)
+				// Main loop
+				cv::Mat frame;
+				int frameCounter = 0;
+				while (video_source.read(frame))
 				{
-					// Render landmarks
-					sfl::render(frame, landmarks_frame);
-
-					// Render overlay
-					string msg = "Frame count: " + std::to_string(++frameCounter);
-					cv::putText(frame, msg, cv::Point(15, 15),
-						cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
-					msg = "Faces found so far: " + std::to_string(faceCounter);
-					cv::putText(frame, msg, cv::Point(15, 40),
-						cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
-					msg = (boost::format("Current frame scale: %.1f") % sfl->getFrameScale()).str();
-					cv::putText(frame, msg, cv::Point(15, 65),
-						cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
-					msg = "Tracking: " + std::string(track ? "Enabled" : "Disabled");
-					cv::putText(frame, msg, cv::Point(15, 90),
-						cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
+					const sfl::Frame& landmarks_frame = sfl->addFrame(frame);
+					faceCounter += landmarks_frame.faces.size();
+
+					if (preview)
+					{
+						// Render landmarks
+						sfl::render(frame, landmarks_frame);
+
+						// Render overlay
+						string msg = "Frame count: " + std::to_string(++frameCounter);
+						cv::putText(frame, msg, cv::Point(15, 15),
+							cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
+						msg = "Faces found so far: " + std::to_string(faceCounter);
+						cv::putText(frame, msg, cv::Point(15, 40),
+							cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
+						msg = (boost::format("Current frame scale: %.1f") % sfl->getFrameScale()).str();
+						cv::putText(frame, msg, cv::Point(15, 65),
+							cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
+						msg = "Tracking: " + std::string(track ? "Enabled" : "Disabled");
+						cv::putText(frame, msg, cv::Point(15, 90),
+							cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
 					
-					cv::putText(frame, "press escape to stop", cv::Point(10, frame.rows - 20),
-						cv::FONT_HERSHEY_COMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
+						cv::putText(frame, "press escape to stop", cv::Point(10, frame.rows - 20),
+							cv::FONT_HERSHEY_COMPLEX, 0.5, cv::Scalar(0, 102, 255), 1, CV_AA);
 
-					// Show frame
-					cv::imshow("sfl_cache", frame);
-					int key = cv::waitKey(1);
-					if (key == 27) break;
+						// Show frame
+						cv::imshow("sfl_cache", frame);
+						int key = cv::waitKey(1);
+						if (key == 27) break;
+					}
 				}
 			}
 
@@ -123,6 +226,7 @@ int main(int argc, char* argv[])
 			{
 				max_faces = faceCounter;
 				best_sfl = sfl;
+				best_stats = segments > 1 ? segment_stats : sfl->getStats();
 			}
 		}
 		
@@ -136,11 +240,18 @@ int main(int argc, char* argv[])
 				(path(outputPath) / (input.stem() += ".lms")).string();
 
 			// Saving to file
-			cout << "Best scale: " << (boost::format("%.1f") % best_sfl->getFrameScale()).str() << endl;
+			if (!adaptive)
+				cout << "Best scale: " << (boost::format("%.1f") % best_sfl->getFrameScale()).str() << endl;
 			cout << "Total faces found: " + std::to_string(max_faces) << endl;
 			cout << "Saving landmarks to \"" << outputPath << "\"." << endl;
             best_sfl->setInputPath(inputPath);
 			best_sfl->save(outputPath);
+
+			if (stats)
+			{
+				cout << "Processing statistics:" << endl;
+				sfl::printStats(cout, best_stats);
+			}
 		}
 	}
 	catch (std::exception& e)
@@ -0,0 +1,102 @@
+// std
+#include <iostream>
+#include <exception>
+
+// Boost
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+
+// sfl
+#include <sfl/sequence_face_landmarks.h>
+#include <sfl/synthetic.h>
+
+// OpenCV
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+using std::cout;
+using std::endl;
+using std::cerr;
+using std::string;
+using std::runtime_error;
+using namespace boost::program_options;
+using namespace boost::filesystem;
+
+int main(int argc, char* argv[])
+{
+	// Parse command line arguments
+	string outputPath, videoPath;
+	sfl::SyntheticParams params;
+	double fps;
+	try {
+		options_description desc("Allowed options");
+		desc.add_options()
+			("help", "display the help message")
+			("output,o", value<string>(&outputPath)->required(), "output landmarks (.lms) path")
+			("video,v", value<string>(&videoPath), "output path for a rendered video of the sequence")
+			("frames,n", value<int>(&params.frames)->default_value(params.frames), "number of frames")
+			("faces,f", value<int>(&params.faces)->default_value(params.faces), "number of faces in each frame")
+			("width,w", value<int>(&params.width)->default_value(params.width), "frame width [pixels]")
+			("height,h", value<int>(&params.height)->default_value(params.height), "frame height [pixels]")
+			("min_size", value<int>(&params.min_face_size)->default_value(params.min_face_size),
+				"minimum face size [pixels]")
+			("max_size", value<int>(&params.max_face_size)->default_value(params.max_face_size),
+				"maximum face size [pixels]")
+			("speed,s", value<float>(&params.speed)->default_value(params.speed),
+				"maximum face speed [pixels / frame]")
+			("churn,c", value<float>(&params.churn)->default_value(params.churn),
+				"probability per frame that a face is replaced by a new face")
+			("seed", value<unsigned int>(&params.seed)->default_value(params.seed), "random seed")
+			("fps", value<double>(&fps)->default_value(30.0), "rendered video frame rate")
+			;
+		variables_map vm;
+		store(command_line_parser(argc, argv).options(desc).
+			positional(positional_options_description().add("output", -1)).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: sfl_synth [options]" << endl;
+			cout << desc << endl;
+			exit(0);
+		}
+		notify(vm);
+	}
+	catch (const error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		exit(1);
+	}
+
+	try
+	{
+		// Generate sequence
+		std::shared_ptr<sfl::SequenceFaceLandmarks> sfl = sfl::SequenceFaceLandmarks::create();
+		sfl::generateSequence(params, sfl->getSequenceMutable());
+
+		// Render video
+		if (!videoPath.empty())
+		{
+			cv::VideoWriter video_writer(videoPath, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
+				fps, cv::Size(params.width, params.height));
+			if (!video_writer.isOpened())
+				throw runtime_error("Failed to open video writer!");
+			cv::Mat frame;
+			for (auto& sfl_frame : sfl->getSequence())
+			{
+				sfl::renderSyntheticFrame(*sfl_frame, frame, params.seed);
+				video_writer.write(frame);
+			}
+			sfl->setInputPath(videoPath);
+			cout << "Rendered video to \"" << videoPath << "\"." << endl;
+		}
+
+		// Write output to file
+		cout << "Saving landmarks to \"" << outputPath << "\"." << endl;
+		sfl->save(outputPath);
+	}
+	catch (std::exception& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
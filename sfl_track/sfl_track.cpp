@@ -10,6 +10,8 @@
 #include <sfl/sequence_face_landmarks.h>
 #include <sfl/face_tracker.h>
 #include <sfl/utilities.h>
+#include <sfl/video_source.h>
+#include <sfl/processing_stats.h>
 
 // OpenCV
 #include <opencv2/core.hpp>
@@ -31,7 +33,8 @@ int main(int argc, char* argv[])
     std::vector<string> inputPaths;
 	string landmarksPath, outputPath, videoPath;
     unsigned int track;
-    bool preview;
+    bool preview, stats;
+    sfl::FaceTrackerLBPParams lbp_params;
 	try {
 		options_description desc("Allowed options");
 		desc.add_options()
@@ -41,7 +44,12 @@ int main(int argc, char* argv[])
             ("output,o", value<string>(&outputPath), "output path")
             ("track,t", value<unsigned int>(&track)->default_value(1),
                 "track faces across frames [1=BRISK|2=LBP]")
+            ("lost_age", value<int>(&lbp_params.max_lost_age)->default_value(lbp_params.max_lost_age),
+                "frames a lost face is kept for re-identification by the LBP tracker [0=unlimited]")
+            ("lost_faces", value<int>(&lbp_params.max_lost_faces)->default_value(lbp_params.max_lost_faces),
+                "maximum lost faces kept by the LBP tracker [0=unlimited]")
             ("preview,p", value<bool>(&preview)->default_value(true), "preview landmarks")
+            ("stats", bool_switch(&stats), "print processing statistics")
 			;
 		variables_map vm;
 		store(command_line_parser(argc, argv).options(desc).
@@ -98,7 +106,7 @@ int main(int argc, char* argv[])
         else
         {
             cout << "Using LBP face tracker." << endl;
-            ft = sfl::createFaceTrackerLBP();
+            ft = sfl::createFaceTrackerLBP(lbp_params);
         }
 
         // Validate video path
@@ -112,19 +120,31 @@ int main(int argc, char* argv[])
         else throw runtime_error("Couldn't find video sequence file!");
 
 		// Create video source
-		cv::VideoCapture video_reader(videoPath);
+		sfl::VideoSource video_source;
+		if (!video_source.open(videoPath))
+			throw runtime_error("Failed to open video source!");
 
 		// Preview loop
 		cv::Mat frame;
 		int frameCounter = 0, faceCounter = 0;
+		sfl::ProcessingStats processing_stats;
 		std::list<std::unique_ptr<sfl::Frame>>& sfl_frames = sfl->getSequenceMutable();
 		std::list<std::unique_ptr<sfl::Frame>>::iterator it = sfl_frames.begin();
-        while (it != sfl_frames.end() && video_reader.read(frame))
+        while (it != sfl_frames.end() && video_source.read(frame))
         {
             std::unique_ptr<sfl::Frame>& sfl_frame = *it++;
             faceCounter += sfl_frame->faces.size();
 
-            ft->addFrame(frame, *sfl_frame);
+            if (stats)
+            {
+                sfl::ProcessingStats::clock::time_point start = sfl::ProcessingStats::clock::now();
+                ft->addFrame(frame, *sfl_frame);
+                sfl::ProcessingStats::clock::time_point end = sfl::ProcessingStats::clock::now();
+                processing_stats.stages[sfl::STAGE_TRACK].add(
+                    std::chrono::duration<double>(end - start).count());
+                processing_stats.addFrame(sfl_frame->faces.size(), start, end);
+            }
+            else ft->addFrame(frame, *sfl_frame);
 
             if (preview)
             {
@@ -156,6 +176,12 @@ int main(int argc, char* argv[])
         // Write output to file
         cout << "Saving landmarks to \"" << outputPath << "\"." << endl;
         sfl->save(outputPath);
+
+        if (stats)
+        {
+            cout << "Processing statistics:" << endl;
+            sfl::printStats(cout, processing_stats);
+        }
 	}
 	catch (std::exception& e)
 	{
@@ -0,0 +1,188 @@
+#include "face_timeline.h"
+
+// std
+#include <algorithm>
+
+// Qt
+#include <QPainter>
+#include <QMouseEvent>
+
+const int CANCEL_CHECK_FRAMES = 4096;   // Frames processed between cancellation checks
+const qreal MAX_ROW_HEIGHT = 8.0;       // Maximum height of a face row [pixels]
+
+namespace sfl
+{
+    void FacePresence::addFrame(int frame_pos, const Frame& frame)
+    {
+        for (auto& face : frame.faces)
+        {
+            auto it = m_index.find(face->id);
+            if (it == m_index.end())
+            {
+                it = m_index.emplace(face->id, m_faces.size()).first;
+                m_faces.push_back({ face->id, {} });
+            }
+
+            // Extend the last range if the face was present in the previous frame
+            auto& ranges = m_faces[it->second].ranges;
+            if (!ranges.empty() && ranges.back().second >= frame_pos - 1)
+                ranges.back().second = std::max(ranges.back().second, frame_pos);
+            else ranges.emplace_back(frame_pos, frame_pos);
+        }
+    }
+
+    void FacePresence::sort()
+    {
+        std::sort(m_faces.begin(), m_faces.end(),
+            [](const FaceRanges& a, const FaceRanges& b) { return a.id < b.id; });
+        for (size_t i = 0; i < m_faces.size(); ++i)
+            m_index[m_faces[i].id] = i;
+    }
+
+    void FacePresence::clear()
+    {
+        m_faces.clear();
+        m_index.clear();
+    }
+
+    FaceTimeline::FaceTimeline(QWidget* parent) : QWidget(parent)
+    {
+        setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+        setMinimumHeight(8);
+    }
+
+    FaceTimeline::~FaceTimeline()
+    {
+        clear();
+    }
+
+    void FaceTimeline::compute(const std::vector<Frame*>& frames, int frame_count)
+    {
+        clear();
+        m_frame_count = frame_count;
+        m_stop = false;
+        m_thread = std::thread(&FaceTimeline::run, this, frames, m_session);
+    }
+
+    void FaceTimeline::reset(int frame_count)
+    {
+        clear();
+        m_frame_count = frame_count;
+    }
+
+    void FaceTimeline::addFrame(int frame_pos, const Frame& frame)
+    {
+        m_presence.addFrame(frame_pos, frame);
+        update();
+    }
+
+    void FaceTimeline::clear()
+    {
+        m_stop = true;
+        if (m_thread.joinable()) m_thread.join();
+
+        // Discard the result that is still queued for the GUI thread
+        ++m_session;
+        m_presence.clear();
+        m_pending.clear();
+        m_frame_count = 0;
+        m_curr_frame = 0;
+        update();
+    }
+
+    void FaceTimeline::setCurrentFrame(int frame_pos)
+    {
+        if (frame_pos == m_curr_frame) return;
+        m_curr_frame = frame_pos;
+        update();
+    }
+
+    QSize FaceTimeline::sizeHint() const
+    {
+        return QSize(QWidget::sizeHint().width(), 32);
+    }
+
+    void FaceTimeline::run(std::vector<Frame*> frames, int session)
+    {
+        FacePresence presence;
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            if (i % CANCEL_CHECK_FRAMES == 0 && m_stop) return;
+            if (frames[i] != nullptr) presence.addFrame((int)i, *frames[i]);
+        }
+        presence.sort();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(m_pending, presence);
+        }
+        QMetaObject::invokeMethod(this, "onComputed", Qt::QueuedConnection,
+            Q_ARG(int, session));
+    }
+
+    void FaceTimeline::onComputed(int session)
+    {
+        if (session != m_session) return;
+        if (m_thread.joinable()) m_thread.join();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(m_presence, m_pending);
+            m_pending.clear();
+        }
+        update();
+    }
+
+    void FaceTimeline::paintEvent(QPaintEvent* event)
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), palette().color(QPalette::Base));
+        const std::vector<FaceRanges>& faces = m_presence.getFaces();
+        if (m_frame_count <= 0) return;
+
+        // Draw each range at least one pixel wide, skip the ranges that fall into
+        // an already drawn pixel column
+        qreal row_height = std::min(qreal(height()) / std::max(faces.size(), (size_t)1),
+            MAX_ROW_HEIGHT);
+        qreal scale = qreal(width()) / m_frame_count;
+        for (size_t i = 0; i < faces.size(); ++i)
+        {
+            QColor color = QColor::fromHsv((faces[i].id * 47) % 360, 200, 220);
+            qreal y = i * row_height;
+            int last_x = -1;
+            for (auto& range : faces[i].ranges)
+            {
+                int x0 = (int)(range.first * scale);
+                int x1 = (int)((range.second + 1) * scale);
+                if (x1 <= last_x) continue;
+                x0 = std::max(x0, last_x);
+                painter.fillRect(QRectF(x0, y, std::max(x1 - x0, 1), row_height), color);
+                last_x = std::max(x1, x0 + 1);
+            }
+        }
+
+        // Draw the current frame
+        int x = (int)((m_curr_frame + 0.5) * scale);
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawLine(x, 0, x, height());
+    }
+
+    void FaceTimeline::mousePressEvent(QMouseEvent* event)
+    {
+        if (event->button() != Qt::LeftButton || m_frame_count <= 0) return;
+        emit frameClicked(frameAt(event->x()));
+    }
+
+    void FaceTimeline::mouseMoveEvent(QMouseEvent* event)
+    {
+        if (!(event->buttons() & Qt::LeftButton) || m_frame_count <= 0) return;
+        int frame_pos = frameAt(event->x());
+        if (frame_pos != m_curr_frame) emit frameClicked(frame_pos);
+    }
+
+    int FaceTimeline::frameAt(int x) const
+    {
+        int frame_pos = (int)(qreal(x) * m_frame_count / std::max(width(), 1));
+        return std::min(std::max(frame_pos, 0), m_frame_count - 1);
+    }
+
+}   // namespace sfl
@@ -0,0 +1,134 @@
+/** @file
+@brief Timeline of the frames in which each face is present.
+*/
+
+#ifndef __SFL_FACE_TIMELINE_H__
+#define __SFL_FACE_TIMELINE_H__
+
+#include <sfl/sequence_face_landmarks.h>
+
+// std
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// Qt
+#include <QWidget>
+
+namespace sfl
+{
+    /** @brief The frame ranges in which a face is present.
+    */
+    struct FaceRanges
+    {
+        int id;                                     ///< Face id.
+        std::vector<std::pair<int, int>> ranges;    ///< Inclusive [first, last] frame ranges.
+    };
+
+    /** @brief Run-length encoded presence of each face in a sequence.
+    Built in a single pass over the frames, in increasing frame order.
+    */
+    class FacePresence
+    {
+    public:
+        /** @brief Add the faces of a frame.
+        @param frame_pos The frame index, not smaller than the previous index.
+        @param frame The frame.
+        */
+        void addFrame(int frame_pos, const Frame& frame);
+
+        /** @brief Sort the faces by id.
+        */
+        void sort();
+
+        /** @brief Remove all faces.
+        */
+        void clear();
+
+        /** @brief Get the faces and their ranges.
+        */
+        const std::vector<FaceRanges>& getFaces() const { return m_faces; }
+
+    private:
+        std::vector<FaceRanges> m_faces;
+        std::unordered_map<int, size_t> m_index;   // Face id to face
+    };
+
+    /** @brief Widget that draws the presence of each face along the video, one row per
+    face, and seeks to the clicked frame.
+    The presence is computed on a background thread.
+    */
+    class FaceTimeline : public QWidget
+    {
+        Q_OBJECT
+
+    public:
+        explicit FaceTimeline(QWidget* parent = nullptr);
+
+        /** @brief Stop the computation.
+        */
+        ~FaceTimeline();
+
+        /** @brief Compute the presence of the faces in the background.
+        The frames must stay valid until the computation is done or clear() is called.
+        @param frames The frames by index, null frames have no faces.
+        @param frame_count The total number of frames in the video.
+        */
+        void compute(const std::vector<Frame*>& frames, int frame_count);
+
+        /** @brief Stop the computation and start an empty timeline.
+        The faces are then added with addFrame() as the frames are processed.
+        @param frame_count The total number of frames in the video.
+        */
+        void reset(int frame_count);
+
+        /** @brief Add the faces of a frame to the timeline.
+        @param frame_pos The frame index, not smaller than the previous index.
+        @param frame The frame.
+        */
+        void addFrame(int frame_pos, const Frame& frame);
+
+        /** @brief Stop the computation and remove the timeline.
+        */
+        void clear();
+
+        /** @brief Set the frame that is marked as the current frame.
+        */
+        void setCurrentFrame(int frame_pos);
+
+        QSize sizeHint() const Q_DECL_OVERRIDE;
+
+    signals:
+        /** @brief A frame was clicked.
+        */
+        void frameClicked(int frame_pos);
+
+    protected:
+        void paintEvent(QPaintEvent* event) Q_DECL_OVERRIDE;
+        void mousePressEvent(QMouseEvent* event) Q_DECL_OVERRIDE;
+        void mouseMoveEvent(QMouseEvent* event) Q_DECL_OVERRIDE;
+
+    private slots:
+        void onComputed(int session);
+
+    private:
+        void run(std::vector<Frame*> frames, int session);
+        int frameAt(int x) const;
+
+    private:
+        FacePresence m_presence;
+        FacePresence m_pending;         // Result of the background computation
+        int m_frame_count = 0;
+        int m_curr_frame = 0;
+        int m_session = 0;              // Identifies the current computation
+        std::atomic<bool> m_stop{ false };
+        std::thread m_thread;
+        std::mutex m_mutex;
+    };
+
+}   // namespace sfl
+
+#endif // __SFL_FACE_TIMELINE_H__
@@ -0,0 +1,197 @@
+#include "frame_cache.h"
+
+// std
+#include <algorithm>
+
+// OpenCV
+#include <opencv2/videoio.hpp>
+
+const int BACKWARD_WINDOW = 16;         // Frames decoded before the playhead per backward seek
+const int MAX_SEQUENTIAL_READ = 32;     // Frames read sequentially instead of seeking
+const size_t MIN_CAPACITY = 8;          // Minimum number of cached frames
+
+namespace sfl
+{
+    FrameCache::FrameCache(size_t max_bytes) :
+        m_capture(new cv::VideoCapture()),
+        m_max_bytes(max_bytes)
+    {
+    }
+
+    FrameCache::~FrameCache()
+    {
+        close();
+    }
+
+    bool FrameCache::open(const std::string& path)
+    {
+        close();
+        if (!m_capture->open(path)) return false;
+
+        // Random access requires the number of frames
+        m_frame_count = (int)m_capture->get(cv::CAP_PROP_FRAME_COUNT);
+        if (m_frame_count <= 0)
+        {
+            m_capture->release();
+            return false;
+        }
+        m_fps = m_capture->get(cv::CAP_PROP_FPS);
+        m_frame_size.width = (int)m_capture->get(cv::CAP_PROP_FRAME_WIDTH);
+        m_frame_size.height = (int)m_capture->get(cv::CAP_PROP_FRAME_HEIGHT);
+
+        // Limit the number of cached frames by their memory
+        size_t frame_bytes = std::max((size_t)m_frame_size.area() * 3, (size_t)1);
+        m_capacity = std::max(m_max_bytes / frame_bytes, MIN_CAPACITY);
+
+        m_capture_pos = 0;
+        m_request = -1;
+        m_playhead = 0;
+        m_direction = 1;
+        m_stop = false;
+        m_opened = true;
+        m_thread = std::thread(&FrameCache::decode, this);
+        return true;
+    }
+
+    void FrameCache::close()
+    {
+        if (m_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_cond.notify_all();
+            m_thread.join();
+        }
+        m_capture->release();
+        m_frames.clear();
+        m_lru.clear();
+        m_failed.clear();
+        m_opened = false;
+    }
+
+    bool FrameCache::get(int i, cv::Mat& frame)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_opened || i < 0 || i >= m_frame_count) return false;
+
+        if (i != m_playhead) m_direction = i < m_playhead ? -1 : 1;
+        m_playhead = i;
+        m_cond.notify_all();    // Prefetch around the new playhead
+
+        // Concurrent callers take turns, each renews its request when woken
+        while (!isCached(i) && m_failed.count(i) == 0 && !m_stop)
+        {
+            m_request = i;
+            m_cond.notify_all();
+            m_cond.wait(lock);
+        }
+        if (m_request == i) m_request = -1;
+
+        auto it = m_frames.find(i);
+        if (it == m_frames.end()) return false;
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+        frame = it->second.frame;
+        return true;
+    }
+
+    void FrameCache::decode()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop)
+        {
+            int target, window_start;
+            if (m_request >= 0 && !isCached(m_request) && m_failed.count(m_request) == 0)
+            {
+                target = m_request;
+                window_start = m_direction < 0 ?
+                    std::max(target - BACKWARD_WINDOW + 1, 0) : target;
+            }
+            else if (!findPrefetchTarget(target, window_start))
+            {
+                m_cond.wait(lock);
+                continue;
+            }
+            decodeStep(lock, target, window_start);
+        }
+    }
+
+    bool FrameCache::findPrefetchTarget(int& target, int& window_start) const
+    {
+        // Keep room for the frames behind the playhead
+        int ahead = std::max((int)m_capacity / 2 - BACKWARD_WINDOW, 1);
+        if (m_direction > 0)
+        {
+            int last = std::min(m_playhead + ahead, m_frame_count - 1);
+            for (int i = m_playhead + 1; i <= last; ++i)
+            {
+                if (isCached(i) || m_failed.count(i) > 0) continue;
+                target = window_start = i;
+                return true;
+            }
+        }
+        else
+        {
+            int first = std::max(m_playhead - ahead, 0);
+            for (int i = m_playhead - 1; i >= first; --i)
+            {
+                if (isCached(i) || m_failed.count(i) > 0) continue;
+                target = i;
+                window_start = std::max(i - BACKWARD_WINDOW + 1, 0);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void FrameCache::decodeStep(std::unique_lock<std::mutex>& lock, int target, int window_start)
+    {
+        // Read sequentially if the capture is at or shortly before the window
+        int pos = m_capture_pos;
+        bool seek = pos < 0 || pos < window_start - MAX_SEQUENTIAL_READ || pos > target;
+        if (seek) pos = window_start;
+
+        // Decode a single frame without holding the lock
+        lock.unlock();
+        cv::Mat frame;
+        bool ok = (!seek || m_capture->set(cv::CAP_PROP_POS_FRAMES, (double)pos)) &&
+            m_capture->read(frame) && !frame.empty();
+        lock.lock();
+
+        if (ok)
+        {
+            m_capture_pos = pos + 1;
+            insert(pos, frame);
+        }
+        else
+        {
+            // Don't retry the frames up to the target, the next read must seek
+            for (int i = pos; i <= target; ++i)
+                if (!isCached(i)) m_failed.insert(i);
+            m_capture_pos = -1;
+        }
+        m_cond.notify_all();
+    }
+
+    void FrameCache::insert(int i, const cv::Mat& frame)
+    {
+        auto it = m_frames.find(i);
+        if (it != m_frames.end())
+        {
+            it->second.frame = frame;
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            return;
+        }
+
+        // Evict the least recently used frames
+        while (m_frames.size() >= m_capacity && !m_lru.empty())
+        {
+            m_frames.erase(m_lru.back());
+            m_lru.pop_back();
+        }
+        m_lru.push_front(i);
+        m_frames[i] = { frame, m_lru.begin() };
+    }
+
+}   // namespace sfl
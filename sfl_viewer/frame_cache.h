@@ -0,0 +1,121 @@
+/** @file
+@brief Cache of decoded video frames for random access.
+*/
+
+#ifndef __SFL_FRAME_CACHE_H__
+#define __SFL_FRAME_CACHE_H__
+
+// std
+#include <string>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+namespace cv
+{
+    class VideoCapture;
+}
+
+namespace sfl
+{
+    /** @brief Least recently used cache of decoded video frames.
+
+    A decode thread owns the video capture. It decodes the requested frames and
+    prefetches frames around the playhead in the current direction. Frames are
+    read sequentially whenever possible, because every seek decodes again from the
+    previous keyframe. Stepping backward seeks once and decodes a window of frames
+    before the playhead, so the next backward steps are served from the cache.
+    */
+    class FrameCache
+    {
+    public:
+        /** @brief Create a frame cache.
+        @param max_bytes The maximum memory used by the cached frames [bytes].
+        */
+        explicit FrameCache(size_t max_bytes = 512 << 20);
+
+        /** @brief Stop decoding and close the video.
+        */
+        ~FrameCache();
+
+        FrameCache(const FrameCache&) = delete;
+        FrameCache& operator=(const FrameCache&) = delete;
+
+        /** @brief Open a video file or an image sequence.
+        @return true if the video was opened successfully.
+        */
+        bool open(const std::string& path);
+
+        /** @brief Stop decoding, close the video and clear the cache.
+        */
+        void close();
+
+        /** @brief Return true if a video is opened.
+        */
+        bool isOpened() const { return m_opened; }
+
+        /** @brief Get a frame and move the playhead to it.
+        If the frame is not cached, wait until it is decoded.
+        The frame is shared with the cache and must not be modified.
+        @param i The frame index.
+        @return false if the frame could not be decoded.
+        */
+        bool get(int i, cv::Mat& frame);
+
+        /** @brief Get the total number of frames.
+        */
+        int getFrameCount() const { return m_frame_count; }
+
+        /** @brief Get the frame rate, or zero if unknown.
+        */
+        double getFPS() const { return m_fps; }
+
+        /** @brief Get the frame size.
+        */
+        const cv::Size& getFrameSize() const { return m_frame_size; }
+
+    private:
+        struct Entry
+        {
+            cv::Mat frame;
+            std::list<int>::iterator lru;
+        };
+
+        void decode();
+        bool findPrefetchTarget(int& target, int& window_start) const;
+        void decodeStep(std::unique_lock<std::mutex>& lock, int target, int window_start);
+        void insert(int i, const cv::Mat& frame);
+        bool isCached(int i) const { return m_frames.find(i) != m_frames.end(); }
+
+    private:
+        std::unique_ptr<cv::VideoCapture> m_capture;   // Only used by the decode thread
+        int m_capture_pos = 0;                          // The next frame read by the capture
+        std::unordered_map<int, Entry> m_frames;
+        std::list<int> m_lru;                           // Most recently used first
+        std::set<int> m_failed;                         // Frames that failed to decode
+        size_t m_max_bytes;
+        size_t m_capacity = 0;                          // Maximum number of cached frames
+        int m_request = -1;                             // Frame waited for by get()
+        int m_playhead = 0;
+        int m_direction = 1;                            // 1 for forward, -1 for backward
+        bool m_stop = false;
+        bool m_opened = false;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+
+        int m_frame_count = 0;
+        double m_fps = 0.0;
+        cv::Size m_frame_size;
+    };
+
+}   // namespace sfl
+
+#endif // __SFL_FRAME_CACHE_H__
@@ -0,0 +1,80 @@
+#include "frame_renderer.h"
+#include <sfl/utilities.h>
+
+// std
+#include <algorithm>
+#include <cmath>
+
+// OpenCV
+#include <opencv2/imgproc.hpp>
+
+namespace sfl
+{
+    QImage FrameRenderer::render(const cv::Mat& frame, const Frame* sfl_frame,
+        const RenderParams& params)
+    {
+        // Reuse the display image unless it is still referenced by a previous caller
+        const cv::Size& display_size = params.display_size;
+        if (m_image.width() != display_size.width || m_image.height() != display_size.height ||
+            !m_image.isDetached())
+        {
+            m_image = QImage(display_size.width, display_size.height, QImage::Format_RGB888);
+            m_image.fill(Qt::black);
+        }
+        if (frame.empty() || display_size.area() == 0) return m_image;
+
+        // Fit the frame to the display
+        float frame_ratio = float(frame.cols) / float(frame.rows);
+        int rh = display_size.height;
+        int rw = (int)std::round(frame_ratio * rh);
+        if (rw > display_size.width)
+        {
+            rw = display_size.width;
+            rh = (int)std::round(rw / frame_ratio);
+        }
+        rw = std::max(rw, 1);
+        rh = std::max(rh, 1);
+        int dx = (display_size.width - rw) / 2;
+        int dy = (display_size.height - rh) / 2;
+
+        // Resize first, so the overlays are drawn at the display's resolution
+        if (rw != frame.cols || rh != frame.rows)
+            cv::resize(frame, m_resized, cv::Size(rw, rh), 0.0, 0.0, cv::INTER_LINEAR);
+        else frame.copyTo(m_resized);
+
+        // Render the scaled faces
+        if (sfl_frame != nullptr)
+        {
+            float sx = float(rw) / float(frame.cols);
+            float sy = float(rh) / float(frame.rows);
+            for (auto& face : sfl_frame->faces)
+            {
+                m_face.id = face->id;
+                m_face.bbox = cv::Rect((int)std::round(face->bbox.x * sx),
+                    (int)std::round(face->bbox.y * sy),
+                    (int)std::round(face->bbox.width * sx),
+                    (int)std::round(face->bbox.height * sy));
+                m_face.landmarks.resize(face->landmarks.size());
+                for (size_t i = 0; i < face->landmarks.size(); ++i)
+                    m_face.landmarks[i] = cv::Point((int)std::round(face->landmarks[i].x * sx),
+                        (int)std::round(face->landmarks[i].y * sy));
+
+                if (params.show_landmarks)
+                    sfl::render(m_resized, m_face.landmarks, params.show_labels,
+                        params.landmarks_color);
+                if (params.show_bbox)
+                    sfl::render(m_resized, m_face.bbox, params.bbox_color);
+                if (params.show_ids)
+                    renderFaceID(m_resized, m_face, params.bbox_color);
+            }
+        }
+
+        // Convert to RGB directly into the display image
+        cv::Mat image(m_image.height(), m_image.width(), CV_8UC3, m_image.bits(),
+            m_image.bytesPerLine());
+        cv::cvtColor(m_resized, image(cv::Rect(dx, dy, rw, rh)), cv::COLOR_BGR2RGB);
+
+        return m_image;
+    }
+
+}   // namespace sfl
@@ -0,0 +1,58 @@
+/** @file
+@brief Rendering of frames with their face landmarks for display.
+*/
+
+#ifndef __SFL_FRAME_RENDERER_H__
+#define __SFL_FRAME_RENDERER_H__
+
+#include <sfl/sequence_face_landmarks.h>
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+// Qt
+#include <QImage>
+
+namespace sfl
+{
+    /** @brief Snapshot of the render parameters.
+    It is copied to the render thread, so it must not refer to any widgets.
+    */
+    struct RenderParams
+    {
+        bool show_landmarks = true;
+        bool show_bbox = true;
+        bool show_ids = true;
+        bool show_labels = false;
+        cv::Size display_size;
+        cv::Scalar landmarks_color = cv::Scalar(0, 255, 0);
+        cv::Scalar bbox_color = cv::Scalar(0, 0, 255);
+    };
+
+    /** @brief Renders frames and their faces into display sized images.
+    The frame is scaled to fit the display and centered, and the faces are drawn
+    on the scaled frame, so the cost depends on the display size rather than the
+    frame size. The buffers are reused between frames. Each thread that renders
+    must use its own renderer.
+    */
+    class FrameRenderer
+    {
+    public:
+        /** @brief Render a frame and its faces.
+        @param frame The BGR video frame, it is not modified.
+        @param sfl_frame The faces of the frame, may be null.
+        @param params The render parameters.
+        @return An RGB image of the display's size. It shares its buffer with the
+        renderer, the next call allocates a new buffer if the image is still in use.
+        */
+        QImage render(const cv::Mat& frame, const Frame* sfl_frame, const RenderParams& params);
+
+    private:
+        cv::Mat m_resized;      // The scaled BGR frame with the overlays
+        QImage m_image;         // The display image
+        Face m_face;            // Scaled face
+    };
+
+}   // namespace sfl
+
+#endif // __SFL_FRAME_RENDERER_H__
@@ -0,0 +1,156 @@
+#include "live_processor.h"
+#include <sfl/utilities.h>
+
+// std
+#include <algorithm>
+#include <iterator>
+#include <exception>
+
+const int RESUME_OVERLAP = 30;  // Frames processed again to match the face ids when resuming
+
+namespace sfl
+{
+    LiveProcessor::LiveProcessor(std::shared_ptr<SequenceFaceLandmarks> sfl) :
+        m_sfl(sfl)
+    {
+    }
+
+    LiveProcessor::~LiveProcessor()
+    {
+        stop();
+    }
+
+    bool LiveProcessor::start(const std::string& video_path)
+    {
+        stop();
+
+        // Publish the frames that were already processed
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frames.clear();
+        m_next_id = 0;
+        for (auto& frame : m_sfl->getSequence())
+        {
+            if (frame->id != (int)m_frames.size())
+            {
+                // Only a contiguous sequence from the first frame can be resumed
+                m_sfl->clear();
+                m_frames.clear();
+                m_next_id = 0;
+                break;
+            }
+            m_frames.push_back(frame.get());
+            for (auto& face : frame->faces)
+                m_next_id = std::max(m_next_id, face->id + 1);
+        }
+
+        int first_frame = std::max((int)m_frames.size() - RESUME_OVERLAP, 0);
+        if (!m_video_source.open(video_path, first_frame)) return false;
+        m_frames.reserve(std::max(m_video_source.getFrameCount(), (int)m_frames.size()));
+        m_error.clear();
+        m_done = false;
+        m_stop = false;
+        m_thread = std::thread(&LiveProcessor::run, this);
+        return true;
+    }
+
+    void LiveProcessor::stop()
+    {
+        m_stop = true;
+        if (m_thread.joinable()) m_thread.join();
+        m_video_source.close();
+    }
+
+    const Frame* LiveProcessor::getFrame(int frame_pos) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (frame_pos < 0 || frame_pos >= (int)m_frames.size()) return nullptr;
+        return m_frames[frame_pos];
+    }
+
+    int LiveProcessor::getProcessedFrames() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return (int)m_frames.size();
+    }
+
+    bool LiveProcessor::isDone() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_done;
+    }
+
+    std::string LiveProcessor::getError() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_error;
+    }
+
+    void LiveProcessor::run()
+    {
+        std::list<std::unique_ptr<Frame>>& sequence = m_sfl->getSequenceMutable();
+        std::list<std::unique_ptr<Frame>> overlap;
+        int resume_pos = (int)m_frames.size();
+        int first_frame = std::max(resume_pos - RESUME_OVERLAP, 0);
+        m_id_map.clear();
+
+        cv::Mat frame;
+        try
+        {
+            for (int frame_pos = first_frame; !m_stop && m_video_source.read(frame); ++frame_pos)
+            {
+                // Keep the frames that were already processed apart, to match the ids
+                if (frame_pos == resume_pos && !overlap.empty())
+                    m_id_map = matchSegmentIds(sequence, overlap);
+                m_sfl->addFrame(frame, frame_pos);
+                if (frame_pos < resume_pos)
+                {
+                    overlap.splice(overlap.end(), sequence, std::prev(sequence.end()));
+                    continue;
+                }
+
+                // Frames are not modified after they were published
+                Frame& sfl_frame = *sequence.back();
+                if (first_frame < resume_pos) relabel(sfl_frame);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_frames.push_back(&sfl_frame);
+                }
+
+                // Notify the GUI thread once it handled the previous notification
+                if (!m_progress_queued.exchange(true))
+                    QMetaObject::invokeMethod(this, "onProgress", Qt::QueuedConnection);
+            }
+        }
+        catch (std::exception& e)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = e.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done = !m_stop && m_error.empty();
+        }
+        m_progress_queued = true;
+        QMetaObject::invokeMethod(this, "onProgress", Qt::QueuedConnection);
+    }
+
+    void LiveProcessor::relabel(Frame& frame)
+    {
+        // Unmatched ids get new ids following the sequence's ids
+        for (auto& face : frame.faces)
+        {
+            auto mapped = m_id_map.find(face->id);
+            if (mapped == m_id_map.end())
+                mapped = m_id_map.insert(std::make_pair(face->id, m_next_id++)).first;
+            face->id = mapped->second;
+        }
+    }
+
+    void LiveProcessor::onProgress()
+    {
+        m_progress_queued = false;
+        emit progress(getProcessedFrames());
+    }
+
+}   // namespace sfl
@@ -0,0 +1,107 @@
+/** @file
+@brief Processing of face landmarks while a video is viewed.
+*/
+
+#ifndef __SFL_LIVE_PROCESSOR_H__
+#define __SFL_LIVE_PROCESSOR_H__
+
+#include <sfl/sequence_face_landmarks.h>
+#include <sfl/video_source.h>
+
+// std
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// Qt
+#include <QObject>
+
+namespace sfl
+{
+    /** @brief Finds the face landmarks of a video on a background thread.
+
+    The frames are processed in order from the first frame, because face tracking
+    requires consecutive frames, with a video source of its own so the viewer's
+    seeking doesn't interrupt the decoding. Each processed frame is published and
+    can be read from any thread while the processing continues.
+
+    A partially processed sequence is resumed after its last frame. The frames
+    before it are processed again to match the new face ids to the sequence's ids.
+    */
+    class LiveProcessor : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        /** @brief Create a live processor.
+        @param sfl The sequence to fill, it must not be accessed until the
+        processing is stopped. If it holds the first frames of the video,
+        processing continues after them.
+        */
+        explicit LiveProcessor(std::shared_ptr<SequenceFaceLandmarks> sfl);
+
+        /** @brief Stop the processing.
+        */
+        ~LiveProcessor();
+
+        /** @brief Start processing a video.
+        @param video_path Path to the video file.
+        @return false if the video could not be opened.
+        */
+        bool start(const std::string& video_path);
+
+        /** @brief Stop the processing and wait for the thread.
+        The frames that were already processed remain in the sequence.
+        */
+        void stop();
+
+        /** @brief Get the faces of a processed frame. Thread safe.
+        @return The frame, or null if the frame was not processed yet.
+        */
+        const Frame* getFrame(int frame_pos) const;
+
+        /** @brief Get the number of processed frames. Thread safe.
+        */
+        int getProcessedFrames() const;
+
+        /** @brief Return true if all the frames were processed. Thread safe.
+        */
+        bool isDone() const;
+
+        /** @brief Get the error that stopped the processing, if any. Thread safe.
+        */
+        std::string getError() const;
+
+    signals:
+        /** @brief More frames were processed, or the processing ended.
+        */
+        void progress(int processed_frames);
+
+    private slots:
+        void onProgress();
+
+    private:
+        void run();
+        void relabel(Frame& frame);
+
+    private:
+        std::shared_ptr<SequenceFaceLandmarks> m_sfl;   // Only used by the processing thread
+        VideoSource m_video_source;
+        std::vector<const Frame*> m_frames;             // The published frames
+        std::map<int, int> m_id_map;                    // Resumed face ids to sequence ids
+        int m_next_id = 0;                              // Next unused face id
+        std::string m_error;
+        bool m_done = false;
+        std::atomic<bool> m_stop{ false };
+        std::atomic<bool> m_progress_queued{ false };
+        std::thread m_thread;
+        mutable std::mutex m_mutex;
+    };
+
+}   // namespace sfl
+
+#endif // __SFL_LIVE_PROCESSOR_H__
@@ -0,0 +1,149 @@
+#include "playback_engine.h"
+
+// std
+#include <cmath>
+
+namespace sfl
+{
+    PlaybackEngine::PlaybackEngine(FrameCache& frame_cache, LandmarksAccessor landmarks,
+        size_t queue_size) :
+        m_frame_cache(frame_cache),
+        m_landmarks(landmarks),
+        m_queue_size(std::max(queue_size, (size_t)1))
+    {
+    }
+
+    PlaybackEngine::~PlaybackEngine()
+    {
+        stop();
+    }
+
+    void PlaybackEngine::start(int first_frame, double fps, const RenderParams& params)
+    {
+        stop();
+        m_first_frame = first_frame;
+        m_fps = fps > 0.0 ? fps : 30.0;
+        m_params = params;
+        m_queue.clear();
+        m_decode_done = false;
+        m_stop = false;
+        m_dropped = 0;
+        ++m_session;
+        m_start_time = clock::now();
+        m_running = true;
+        m_decode_thread = std::thread(&PlaybackEngine::decode, this);
+        m_render_thread = std::thread(&PlaybackEngine::render, this);
+    }
+
+    void PlaybackEngine::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        if (m_decode_thread.joinable()) m_decode_thread.join();
+        if (m_render_thread.joinable()) m_render_thread.join();
+        m_queue.clear();
+        m_running = false;
+
+        // Discard the images that are still queued for the GUI thread
+        ++m_session;
+    }
+
+    void PlaybackEngine::setRenderParams(const RenderParams& params)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_params = params;
+    }
+
+    PlaybackEngine::clock::time_point PlaybackEngine::getPresentationTime(int frame_pos) const
+    {
+        return m_start_time + std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>((frame_pos - m_first_frame) / m_fps));
+    }
+
+    void PlaybackEngine::decode()
+    {
+        const int frame_count = m_frame_cache.getFrameCount();
+        int frame_pos = m_first_frame;
+        cv::Mat frame;
+        while (frame_pos < frame_count)
+        {
+            // Skip the frames whose presentation time has already passed
+            std::chrono::duration<double> elapsed = clock::now() - m_start_time;
+            int due_pos = m_first_frame + (int)std::floor(elapsed.count() * m_fps);
+            if (due_pos > frame_pos)
+            {
+                m_dropped += std::min(due_pos, frame_count) - frame_pos;
+                frame_pos = due_pos;
+                if (frame_pos >= frame_count) break;
+            }
+
+            bool ok = m_frame_cache.get(frame_pos, frame);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return m_queue.size() < m_queue_size || m_stop; });
+            if (m_stop) return;
+            if (ok) m_queue.push_back({ frame_pos, frame });
+            ++frame_pos;
+            m_cond.notify_all();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decode_done = true;
+        m_cond.notify_all();
+    }
+
+    void PlaybackEngine::render()
+    {
+        const clock::duration frame_duration = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(1.0 / m_fps));
+        const int session = m_session;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_cond.wait(lock, [this]() { return !m_queue.empty() || m_decode_done || m_stop; });
+            if (m_stop) return;
+            if (m_queue.empty()) break;
+            Item item = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_cond.notify_all();
+
+            // Drop the frame if it is late and a newer frame is already waiting
+            clock::time_point presentation_time = getPresentationTime(item.frame_pos);
+            if (!m_queue.empty() && clock::now() > presentation_time + frame_duration)
+            {
+                ++m_dropped;
+                continue;
+            }
+            RenderParams params = m_params;
+
+            lock.unlock();
+            QImage image = m_renderer.render(item.frame, m_landmarks(item.frame_pos), params);
+            lock.lock();
+
+            // Wait for the presentation time
+            if (m_cond.wait_until(lock, presentation_time, [this]() { return m_stop; })) return;
+
+            // Deliver the image to the GUI thread
+            QMetaObject::invokeMethod(this, "onImageRendered", Qt::QueuedConnection,
+                Q_ARG(QImage, image), Q_ARG(int, item.frame_pos), Q_ARG(int, session));
+        }
+        QMetaObject::invokeMethod(this, "onEndReached", Qt::QueuedConnection,
+            Q_ARG(int, session));
+    }
+
+    void PlaybackEngine::onImageRendered(QImage image, int frame_pos, int session)
+    {
+        if (session == m_session) emit frameReady(image, frame_pos);
+    }
+
+    void PlaybackEngine::onEndReached(int session)
+    {
+        if (session != m_session) return;
+        stop();
+        emit finished();
+    }
+
+}   // namespace sfl
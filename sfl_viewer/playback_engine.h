@@ -0,0 +1,125 @@
+/** @file
+@brief Video playback on background decode and render threads.
+*/
+
+#ifndef __SFL_PLAYBACK_ENGINE_H__
+#define __SFL_PLAYBACK_ENGINE_H__
+
+#include "frame_cache.h"
+#include "frame_renderer.h"
+
+// std
+#include <deque>
+#include <functional>
+#include <chrono>
+#include <atomic>
+
+// Qt
+#include <QObject>
+#include <QImage>
+
+namespace sfl
+{
+    /** @brief Plays a video on background threads.
+
+    A decode thread reads the frames from the frame cache into a bounded queue and
+    a render thread renders them and hands the finished images to the GUI thread
+    at their presentation time. Frames are dropped against the wall clock when
+    decoding or rendering falls behind, so the playback keeps its speed.
+    */
+    class PlaybackEngine : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        /** @brief Get the faces of a frame, or null if there are none.
+        Called from the render thread.
+        */
+        typedef std::function<const Frame*(int)> LandmarksAccessor;
+
+        /** @brief Create a playback engine.
+        @param frame_cache The source of the frames.
+        @param landmarks Accessor of the faces of each frame.
+        @param queue_size The maximum number of decoded frames waiting to be rendered.
+        */
+        PlaybackEngine(FrameCache& frame_cache, LandmarksAccessor landmarks,
+            size_t queue_size = 4);
+
+        /** @brief Stop the playback.
+        */
+        ~PlaybackEngine();
+
+        /** @brief Start playing.
+        @param first_frame The index of the first frame to play.
+        @param fps The playback frame rate [frames / second].
+        @param params The render parameters.
+        */
+        void start(int first_frame, double fps, const RenderParams& params);
+
+        /** @brief Stop playing and wait for the threads.
+        Frames that were already handed to the GUI thread are discarded.
+        */
+        void stop();
+
+        /** @brief Return true if the playback is running.
+        */
+        bool isRunning() const { return m_running; }
+
+        /** @brief Set the render parameters of the next frames.
+        */
+        void setRenderParams(const RenderParams& params);
+
+        /** @brief Get the number of frames dropped since the playback started.
+        */
+        int getDroppedFrames() const { return m_dropped; }
+
+    signals:
+        /** @brief A frame is ready to be displayed.
+        */
+        void frameReady(QImage image, int frame_pos);
+
+        /** @brief The playback reached the end of the video.
+        */
+        void finished();
+
+    private slots:
+        void onImageRendered(QImage image, int frame_pos, int session);
+        void onEndReached(int session);
+
+    private:
+        typedef std::chrono::steady_clock clock;
+
+        struct Item
+        {
+            int frame_pos;
+            cv::Mat frame;
+        };
+
+        void decode();
+        void render();
+        clock::time_point getPresentationTime(int frame_pos) const;
+
+    private:
+        FrameCache& m_frame_cache;
+        LandmarksAccessor m_landmarks;
+        size_t m_queue_size;
+        std::deque<Item> m_queue;
+        RenderParams m_params;
+        FrameRenderer m_renderer;       // Only used by the render thread
+        int m_first_frame = 0;
+        double m_fps = 30.0;
+        clock::time_point m_start_time;
+        bool m_decode_done = false;
+        bool m_stop = false;
+        bool m_running = false;
+        int m_session = 0;              // Identifies the images of the current playback
+        std::atomic<int> m_dropped{ 0 };
+        std::thread m_decode_thread;
+        std::thread m_render_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+    };
+
+}   // namespace sfl
+
+#endif // __SFL_PLAYBACK_ENGINE_H__
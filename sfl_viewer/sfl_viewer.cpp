@@ -18,6 +18,7 @@
 #include <QFileDialog>
 #include <QResizeEvent>
 #include <QMessageBox>//
+#include <QSignalBlocker>
 
 using namespace boost::filesystem;
 
@@ -30,6 +31,17 @@ namespace sfl
         setupBl();
     }
 
+    Viewer::~Viewer()
+    {
+        // Leave the states and stop all threads before the members are destroyed
+        sm.terminate();
+        playback = nullptr;
+        stopLiveProcessing();
+
+        // The timeline refers to the frames of the sequence
+        face_timeline->clear();
+    }
+
     void Viewer::setupBl()
     {
         // Initialize state machine
@@ -42,6 +54,7 @@ namespace sfl
         connect(actionBackward, &QAction::triggered, this, &Viewer::backward);
         connect(actionForward, &QAction::triggered, this, &Viewer::forward);
         connect(frame_slider, SIGNAL(valueChanged(int)), this, SLOT(frameSliderChanged(int)));
+        connect(face_timeline, &FaceTimeline::frameClicked, this, &Viewer::frameSliderChanged);
         connect(actionShowLandmarks, SIGNAL(toggled(bool)), this, SLOT(toggleRenderParams(bool)));
         connect(actionShowBBox, SIGNAL(toggled(bool)), this, SLOT(toggleRenderParams(bool)));
         connect(actionShowIDs, SIGNAL(toggled(bool)), this, SLOT(toggleRenderParams(bool)));
@@ -62,11 +75,21 @@ namespace sfl
         else initVideoSource(input_path);
     }
 
+    void Viewer::setLandmarksModel(const std::string& _model_path)
+    {
+        model_path = _model_path;
+    }
+
     void Viewer::initLandmarks(const std::string & _landmarks_path)
     {
         if (!is_regular_file(_landmarks_path)) return;
         if (landmarks_path == _landmarks_path) return;
 
+        // The render thread and the timeline read the frames of the current sequence
+        stopPlaying();
+        stopLiveProcessing();
+        face_timeline->clear();
+        sfl_frames.clear();
         sfl = sfl::SequenceFaceLandmarks::create(_landmarks_path);
         landmarks_path = _landmarks_path;
         initVideoSource(sfl->getInputPath());
@@ -78,17 +101,107 @@ namespace sfl
         if (!is_regular_file(_sequence_path)) return;
         if (sequence_path == _sequence_path) return;
 
-		video_reader.reset(new cv::VideoCapture());
-		if (!video_reader->open(_sequence_path)) video_reader = nullptr;
-		else
+        stopPlaying();
+        playback = nullptr;
+        stopLiveProcessing();
+        frame_cache.reset(new FrameCache());
+        if (!frame_cache->open(_sequence_path))
+        {
+            // Nothing is left to view
+            frame_cache = nullptr;
+            sequence_path.clear();
+            face_timeline->clear();
+            frame_slider->setEnabled(false);
+            sm.process_event(EvReset());
+        }
+        else
 		{
 			sequence_path = _sequence_path;
 			path input = path(sequence_path);
-			initLandmarks((input.parent_path() / (input.stem() += ".lms")).string());
+			std::string _landmarks_path = (input.parent_path() / (input.stem() += ".lms")).string();
+
+			// Without a landmarks cache, find the landmarks while viewing
+			if (!is_regular_file(_landmarks_path) && !model_path.empty())
+				initLiveProcessing(_landmarks_path);
+			else initLandmarks(_landmarks_path);
 			sm.process_event(EvStart());
 		}
     }
 
+    void Viewer::stopPlaying()
+    {
+        // Return to paused, starting a new sequence doesn't restart the playback
+        if (sm.state_cast<const Playing*>() != nullptr)
+            sm.process_event(EvPlayPause());
+    }
+
+    void Viewer::initLiveProcessing(const std::string& _landmarks_path)
+    {
+        stopLiveProcessing();
+        face_timeline->clear();
+        sfl_frames.clear();
+
+        sfl = sfl::SequenceFaceLandmarks::create(model_path, 1.0f, sfl::TRACKING_BRISK);
+        landmarks_path = _landmarks_path;
+
+        // Resume from the frames saved when the viewer was closed before the end
+        std::string partial_path = getPartialLandmarksPath();
+        if (is_regular_file(partial_path))
+        {
+            try
+            {
+                sfl->load(partial_path);
+            }
+            catch (std::exception& e)
+            {
+                std::cerr << e.what() << std::endl;
+                sfl->clear();
+            }
+        }
+        sfl->setInputPath(sequence_path);
+        live.reset(new LiveProcessor(sfl));
+        connect(live.get(), &LiveProcessor::progress, this, &Viewer::liveProgress);
+        live_frames = 0;
+        if (!live->start(sequence_path))
+        {
+            live = nullptr;
+            sfl = nullptr;
+            landmarks_path.clear();
+        }
+    }
+
+    void Viewer::stopLiveProcessing()
+    {
+        if (live == nullptr) return;
+
+        // The render thread reads the live frames
+        if (playback != nullptr) playback->stop();
+        live->stop();
+        bool done = live->isDone();
+        live = nullptr;
+
+        // Only a complete sequence is saved as the landmarks cache of the video,
+        // otherwise the processing is resumed from the partial file
+        if (sfl->size() == 0) return;
+        std::string partial_path = getPartialLandmarksPath();
+        std::string output_path = done ? landmarks_path : partial_path;
+        try
+        {
+            sfl->save(output_path);
+            if (done) boost::filesystem::remove(partial_path);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Failed to save landmarks to \"" << output_path << "\": " <<
+                e.what() << std::endl;
+        }
+    }
+
+    std::string Viewer::getPartialLandmarksPath() const
+    {
+        return path(landmarks_path).replace_extension(".partial.lms").string();
+    }
+
     void Viewer::resizeEvent(QResizeEvent* event)
     {
         QMainWindow::resizeEvent(event);
@@ -106,11 +219,6 @@ namespace sfl
         sm.process_event(EvUpdate());
     }
 
-    void Viewer::timerEvent(QTimerEvent *event)
-    {
-        sm.process_event(EvTimerTick());
-    }
-
     void Viewer::open()
     {
         QString file = QFileDialog::getOpenFileName(
@@ -154,45 +262,80 @@ namespace sfl
 
     void Viewer::render()
     {
-        // Render landmarks
-        landmarks_render_frame = frame.clone();
+        QImage image = renderer.render(frame, getLandmarks(curr_frame_pos), getRenderParams());
 
-        for (auto& face : sfl_frames[curr_frame_pos]->faces)
-        {
-            if (actionShowLandmarks->isChecked())
-                sfl::render(landmarks_render_frame, face->landmarks, 
-                    actionShowLabels->isChecked(), landmarks_color);
-            if (actionShowBBox->isChecked())
-                sfl::render(landmarks_render_frame, face->bbox, bbox_color);
-            if (actionShowIDs->isChecked())
-                renderFaceID(landmarks_render_frame, *face, bbox_color);
-        } 
-
-        // Resize frame
-        QSize displaySize = display->size();
-        if (displaySize.width() != frame.cols || displaySize.height() != frame.rows)
+        // Render to display
+        display->setPixmap(QPixmap::fromImage(image));
+        display->update();
+    }
+
+    void Viewer::playbackFrameReady(QImage image, int frame_pos)
+    {
+        // Update the slider without seeking
+        curr_frame_pos = frame_pos;
         {
-            float frame_ratio = float(frame.cols) / float(frame.rows);
-            int rh = displaySize.height();
-            int rw = (int)std::round(frame_ratio * rh);
-            if (rw > displaySize.width())
-            {
-                rw = displaySize.width();
-                rh = (int)std::round(rw / frame_ratio);
-            }
-            cv::resize(landmarks_render_frame, resized_frame, cv::Size(rw, rh), 0.0, 0.0, cv::INTER_CUBIC);
+            QSignalBlocker blocker(frame_slider);
+            frame_slider->setValue(curr_frame_pos);
         }
-        else resized_frame = landmarks_render_frame;
-
-        // Create render frame
-        int dx = (displaySize.width() - resized_frame.cols) / 2;
-        int dy = (displaySize.height() - resized_frame.rows) / 2;
-        resized_frame.copyTo(render_frame(cv::Rect(dx, dy, resized_frame.cols, resized_frame.rows)));
+        face_timeline->setCurrentFrame(curr_frame_pos);
+        curr_frame_lbl->setText(std::to_string(curr_frame_pos).c_str());
 
         // Render to display
-        display->setPixmap(QPixmap::fromImage(render_image->rgbSwapped()));
+        display->setPixmap(QPixmap::fromImage(image));
         display->update();
     }
 
+    void Viewer::playbackFinished()
+    {
+        if (sm.state_cast<const Playing*>() != nullptr)
+            sm.process_event(EvPlayPause());
+    }
+
+    void Viewer::liveProgress(int processed_frames)
+    {
+        if (live == nullptr) return;
+
+        // Add the new frames to the timeline
+        int prev_frames = live_frames;
+        for (; live_frames < processed_frames; ++live_frames)
+        {
+            const Frame* sfl_frame = live->getFrame(live_frames);
+            if (sfl_frame != nullptr) face_timeline->addFrame(live_frames, *sfl_frame);
+        }
+
+        // Show the landmarks of the displayed frame once it was processed
+        if (curr_frame_pos >= prev_frames && curr_frame_pos < processed_frames &&
+            sm.state_cast<const Paused*>() != nullptr)
+            sm.process_event(EvUpdate());
+
+        std::string error = live->getError();
+        if (!error.empty())
+            statusbar->showMessage(("Processing failed: " + error).c_str());
+        else if (live->isDone())
+            statusbar->showMessage("Processing done", 5000);
+        else statusbar->showMessage(("Processing frame " + std::to_string(processed_frames) +
+            " / " + std::to_string(total_frames)).c_str());
+    }
+
+    RenderParams Viewer::getRenderParams() const
+    {
+        RenderParams params;
+        params.show_landmarks = actionShowLandmarks->isChecked();
+        params.show_bbox = actionShowBBox->isChecked();
+        params.show_ids = actionShowIDs->isChecked();
+        params.show_labels = actionShowLabels->isChecked();
+        params.display_size = cv::Size(display->width(), display->height());
+        params.landmarks_color = landmarks_color;
+        params.bbox_color = bbox_color;
+        return params;
+    }
+
+    const sfl::Frame* Viewer::getLandmarks(int frame_pos) const
+    {
+        if (live != nullptr) return live->getFrame(frame_pos);
+        if (frame_pos < 0 || frame_pos >= (int)sfl_frames.size()) return nullptr;
+        return sfl_frames[frame_pos];
+    }
+
 }   // namespace sfl
 
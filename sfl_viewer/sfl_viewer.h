@@ -3,12 +3,16 @@
 
 #include "ui_sfl_viewer.h"
 #include "sfl_viewer_states.h"
+#include "frame_cache.h"
+#include "frame_renderer.h"
+#include "playback_engine.h"
+#include "live_processor.h"
 
 #include <sfl/sequence_face_landmarks.h>
 
 #include <string>
 
-#include <opencv2/videoio.hpp>
+#include <opencv2/core.hpp>
 
 // Qt
 
@@ -20,15 +24,22 @@ namespace sfl
 
     public:
         Viewer();
+        ~Viewer();
         void setupBl();
 
         void setInputPath(const std::string& input_path);
+        void setLandmarksModel(const std::string& _model_path);
         void initLandmarks(const std::string& _landmarks_path);
         void initVideoSource(const std::string& _sequence_path);
+        void initLiveProcessing(const std::string& _landmarks_path);
+        void stopLiveProcessing();
+        void stopPlaying();
+        std::string getPartialLandmarksPath() const;
+        RenderParams getRenderParams() const;
+        const sfl::Frame* getLandmarks(int frame_pos) const;
 
     protected:
         void resizeEvent(QResizeEvent* event) Q_DECL_OVERRIDE;
-        void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE;
 
     public slots:
         void open();
@@ -39,6 +50,9 @@ namespace sfl
         void frameSliderChanged(int i);
         void toggleRenderParams(bool toggled);
         void render();
+        void playbackFrameReady(QImage image, int frame_pos);
+        void playbackFinished();
+        void liveProgress(int processed_frames);
 
     public:
         ViewerSM sm;
@@ -46,10 +60,12 @@ namespace sfl
         std::string landmarks_path;
 
         // Video
-		std::unique_ptr<cv::VideoCapture> video_reader;
-        cv::Mat frame, resized_frame, landmarks_render_frame;
+        std::unique_ptr<FrameCache> frame_cache;
+        std::unique_ptr<PlaybackEngine> playback;
+        cv::Mat frame;
         cv::Mat render_frame;
         std::unique_ptr<QImage> render_image;
+        FrameRenderer renderer;
         int curr_frame_pos = 0;
         int total_frames = 0;
         double fps = 0.0;
@@ -57,10 +73,11 @@ namespace sfl
         // sfl
         std::shared_ptr<sfl::SequenceFaceLandmarks> sfl;
         std::vector<sfl::Frame*> sfl_frames;
+        std::string model_path;
+        std::unique_ptr<LiveProcessor> live;
+        int live_frames = 0;                    // Live frames added to the timeline
         cv::Scalar landmarks_color = cv::Scalar(0, 255, 0);
         cv::Scalar bbox_color = cv::Scalar(0, 0, 255);
-
-        int timer_id = 0;
     };
 
 }   // namespace sfl
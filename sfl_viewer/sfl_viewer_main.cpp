@@ -24,7 +24,7 @@ int main(int argc, char* argv[])
 {
     // Parse command line arguments
     std::vector<string> inputPaths;
-    string landmarksPath, videoPath;
+    string landmarksPath, videoPath, landmarksModelPath;
     bool draw_ind;
     try {
         options_description desc("Allowed options");
@@ -34,6 +34,8 @@ int main(int argc, char* argv[])
                 "path to video or landmarks (.lms) files")
                 ("draw_ind,d", value<bool>(&draw_ind)->default_value(false)->implicit_value(true),
                     "draw landmark indices")
+                ("landmarks,l", value<string>(&landmarksModelPath),
+                    "path to landmarks model file, videos without a landmarks cache (.lms) are processed while viewed")
             ;
         variables_map vm;
         store(command_line_parser(argc, argv).options(desc).
@@ -45,6 +47,8 @@ int main(int argc, char* argv[])
         }
         notify(vm);
         if (inputPaths.size() > 2) throw error("Too many input arguments!");
+        if (!landmarksModelPath.empty() && !is_regular_file(landmarksModelPath))
+            throw error("landmarks must be a path to a file!");
     }
     catch (const error& e) {
         cout << "Error while parsing command-line arguments: " << e.what() << endl;
@@ -56,6 +60,7 @@ int main(int argc, char* argv[])
     {
         QApplication a(argc, argv);
         sfl::Viewer viewer;
+        viewer.setLandmarksModel(landmarksModelPath);
         for (string& inputPath : inputPaths)
             viewer.setInputPath(inputPath);
         viewer.show();
@@ -7,7 +7,6 @@
 #include <boost/filesystem.hpp>
 
 // Qt
-#include <QTimer>
 #include <QMessageBox>
 
 using namespace boost::filesystem;
@@ -32,7 +31,7 @@ namespace sfl
 
     sc::result Inactive::react(const EvStart &)
     {
-        if (viewer->video_reader == nullptr || viewer->sfl == nullptr)
+        if (viewer->frame_cache == nullptr || viewer->sfl == nullptr)
         {
             QMessageBox msgBox;
             msgBox.setText("Failed to open sequence sources.");
@@ -52,11 +51,11 @@ namespace sfl
     {
         if (event.i < 0 || event.i >= viewer->total_frames) return;
 
-		viewer->video_reader->set(cv::CAP_PROP_POS_FRAMES, (double)event.i);
-		if(viewer->video_reader->read(viewer->frame))
+        if (viewer->frame_cache->get(event.i, viewer->frame))
         {
             viewer->curr_frame_pos = event.i;
             viewer->frame_slider->setValue(viewer->curr_frame_pos);
+            viewer->face_timeline->setCurrentFrame(viewer->curr_frame_pos);
             viewer->curr_frame_lbl->setText(std::to_string(viewer->curr_frame_pos).c_str());
             post_event(EvUpdate());
         }
@@ -65,18 +64,17 @@ namespace sfl
     void Active::onStart(const EvStart & event)
     {
         // Reshape window
-		int width = (int)viewer->video_reader->get(cv::CAP_PROP_FRAME_WIDTH);
-		int height = (int)viewer->video_reader->get(cv::CAP_PROP_FRAME_HEIGHT);
+        int width = viewer->frame_cache->getFrameSize().width;
+        int height = viewer->frame_cache->getFrameSize().height;
         viewer->display->setMinimumSize(width, height);
         viewer->adjustSize();
 
         // Read first video frame
         viewer->curr_frame_pos = 0;
-        viewer->total_frames = (int)viewer->video_reader->get(cv::CAP_PROP_FRAME_COUNT);
-		viewer->fps = viewer->video_reader->get(cv::CAP_PROP_FPS);
+        viewer->total_frames = viewer->frame_cache->getFrameCount();
+        viewer->fps = viewer->frame_cache->getFPS();
         if (viewer->fps < 1.0) viewer->fps = 30.0;
-		viewer->video_reader->set(cv::CAP_PROP_POS_FRAMES, (double)viewer->curr_frame_pos);
-		viewer->video_reader->read(viewer->frame);
+        viewer->frame_cache->get(viewer->curr_frame_pos, viewer->frame);
 //        if (viewer->vs->read())
 //            viewer->frame = viewer->vs->getFrame();
 
@@ -84,12 +82,30 @@ namespace sfl
         QSize displaySize = viewer->display->size();
         viewer->render_frame = cv::Mat::zeros(displaySize.height(), displaySize.width(), CV_8UC3);
 
-        // Get sfl frames
-        const std::list<std::unique_ptr<Frame>>& sfl_frames_list = viewer->sfl->getSequence();
+        // Create the playback engine
+        Viewer* v = viewer;
+        viewer->playback.reset(new PlaybackEngine(*viewer->frame_cache,
+            [v](int frame_pos) { return v->getLandmarks(frame_pos); }));
+        QObject::connect(viewer->playback.get(), &PlaybackEngine::frameReady,
+            viewer, &Viewer::playbackFrameReady);
+        QObject::connect(viewer->playback.get(), &PlaybackEngine::finished,
+            viewer, &Viewer::playbackFinished);
+
+        // Get sfl frames, the frames of a live sequence are published by its processor
         viewer->sfl_frames.clear();
-        viewer->sfl_frames.reserve(sfl_frames_list.size());
-        for (auto& frame : sfl_frames_list)
-            viewer->sfl_frames.push_back(frame.get());
+        if (viewer->live != nullptr)
+        {
+            viewer->face_timeline->reset(viewer->total_frames);
+            viewer->live_frames = 0;
+        }
+        else if (viewer->sfl != nullptr)
+        {
+            const std::list<std::unique_ptr<Frame>>& sfl_frames_list = viewer->sfl->getSequence();
+            viewer->sfl_frames.reserve(sfl_frames_list.size());
+            for (auto& frame : sfl_frames_list)
+                viewer->sfl_frames.push_back(frame.get());
+            viewer->face_timeline->compute(viewer->sfl_frames, viewer->total_frames);
+        }
 
         // Initialize widgets
         path title(path(viewer->sequence_path).filename() += path(" / ") +=
@@ -121,34 +137,37 @@ namespace sfl
         viewer->actionPlay->setIcon(
             QIcon::fromTheme(QStringLiteral(":/images/pause.png")));
 
-        // Start timer
-        timer_id = viewer->startTimer((int)std::round(1000.0 / viewer->fps));
+        // Start playback from the next frame
+        if (viewer->playback == nullptr || viewer->curr_frame_pos >= (viewer->total_frames - 1))
+            post_event(EvPlayPause());
+        else viewer->playback->start(viewer->curr_frame_pos + 1, viewer->fps,
+            viewer->getRenderParams());
     }
 
     Playing::~Playing()
     {
-        viewer->killTimer(timer_id);
+        if (viewer->playback != nullptr) viewer->playback->stop();
+
+        // Keep the displayed frame for rendering while paused
+        if (viewer->frame_cache != nullptr)
+            viewer->frame_cache->get(viewer->curr_frame_pos, viewer->frame);
     }
 
     void Playing::onUpdate(const EvUpdate& event)
     {
-        viewer->render();
+        if (viewer->playback != nullptr)
+            viewer->playback->setRenderParams(viewer->getRenderParams());
     }
 
-    void Playing::onTimerTick(const EvTimerTick& event)
+    void Playing::onSeek(const EvSeek& event)
     {
-        if (viewer->curr_frame_pos >= (viewer->total_frames - 1))
-        {
-            post_event(EvPlayPause());
-            return;
-        }
-
-		if (viewer->video_reader->read(viewer->frame))
-		{
-			viewer->frame_slider->setValue(++viewer->curr_frame_pos);
-			viewer->curr_frame_lbl->setText(std::to_string(viewer->curr_frame_pos).c_str());
-			post_event(EvUpdate());
-		}
+        // Continue playing from the new position
+        if (viewer->playback == nullptr) return;
+        viewer->playback->stop();
+        context<Active>().onSeek(event);
+        if (viewer->curr_frame_pos < (viewer->total_frames - 1))
+            viewer->playback->start(viewer->curr_frame_pos + 1, viewer->fps,
+                viewer->getRenderParams());
     }
 }   // namespace sfl
 
@@ -39,7 +39,6 @@ namespace sfl
     struct EvUpdate : sc::event< EvUpdate > {};
     struct EvStart : sc::event< EvStart > {};
     struct EvReset : sc::event< EvReset > {};
-    struct EvTimerTick : sc::event< EvTimerTick > {};
     struct EvSeek : sc::event< EvSeek > 
     {
         EvSeek(int _i) : i(_i) {}
@@ -97,15 +96,14 @@ namespace sfl
         ~Playing();
 
         void onUpdate(const EvUpdate& event);
-        void onTimerTick(const EvTimerTick& event);
+        void onSeek(const EvSeek& event);
 
         typedef mpl::list<
             sc::in_state_reaction<EvUpdate, Playing, (void(Playing::*)(const EvUpdate&))(&Playing::onUpdate)>,
-            sc::in_state_reaction<EvTimerTick, Playing, (void(Playing::*)(const EvTimerTick&))(&Playing::onTimerTick)>,
+            sc::in_state_reaction<EvSeek, Playing, (void(Playing::*)(const EvSeek&))(&Playing::onSeek)>,
             sc::transition< EvPlayPause, Paused > > reactions;
 
         Viewer* viewer;
-        int timer_id = 0;
     };
 }   // namespace sfl
 